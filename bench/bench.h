@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+/*
+ * Minimal helpers shared by the benchmarks: wall clock timing, a sink that
+ * keeps results alive, percentiles and a uniform report line. Each
+ * benchmark is a plain executable taking its sizes from the command line.
+ */
+namespace bench {
+
+using clock = std::chrono::steady_clock;
+
+/**
+ * run f once.
+ * @return elapsed wall time in nanoseconds
+ */
+template <typename F>
+double time_ns(F&& f) {
+  auto start = clock::now();
+  f();
+  return std::chrono::duration<double, std::nano>(clock::now() - start)
+      .count();
+}
+
+/**
+ * run f repeats times.
+ * @return fastest run in nanoseconds
+ */
+template <typename F>
+double best_ns(int repeats, F&& f) {
+  double best = time_ns(f);
+  for (int i = 1; i < repeats; ++i) best = std::min(best, time_ns(f));
+  return best;
+}
+
+/**
+ * keep value alive so that the work producing it is not optimized out.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * p-th percentile of samples, p in [0, 100]. Reorders samples.
+ */
+inline double percentile(std::vector<double>& samples, double p) {
+  if (samples.empty()) return 0;
+  size_t k = static_cast<size_t>(p / 100 * (samples.size() - 1));
+  std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+  return samples[k];
+}
+
+/**
+ * positional size argument index, or fallback when it is missing.
+ */
+inline size_t size_arg(int argc, char** argv, int index, size_t fallback) {
+  if (index >= argc) return fallback;
+  return std::strtoull(argv[index], nullptr, 0);
+}
+
+/**
+ * print one result line: time per operation and throughput.
+ * @param name what was measured
+ * @param variant implementation or parameters
+ * @param ops number of operations timed
+ * @param ns total time in nanoseconds
+ */
+inline void report(const char* name, const char* variant, size_t ops,
+                   double ns) {
+  double per_op = ops ? ns / static_cast<double>(ops) : 0;
+  std::printf("%-24s %-32s %10.2f ns/op %10.2f Mops/s\n", name, variant,
+              per_op, per_op > 0 ? 1e3 / per_op : 0.0);
+}
+
+/**
+ * print the latency distribution of samples, one duration per operation in
+ * nanoseconds. Reorders samples.
+ */
+inline void report_latency(const char* name, const char* variant,
+                           std::vector<double>& samples) {
+  std::printf("%-24s %-32s p50 %8.0f  p99 %8.0f  p99.9 %8.0f  max %8.0f ns\n",
+              name, variant, percentile(samples, 50), percentile(samples, 99),
+              percentile(samples, 99.9), percentile(samples, 100));
+}
+
+/**
+ * run body(i) on threads threads, released together.
+ * @return wall time from the release until the last thread finished
+ */
+template <typename F>
+double run_threads(int threads, F&& body) {
+  std::atomic<int> ready{0};
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; ++i) {
+    workers.emplace_back([&, i] {
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      body(i);
+    });
+  }
+  while (ready.load() != threads) std::this_thread::yield();
+  auto start = clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& t : workers) t.join();
+  return std::chrono::duration<double, std::nano>(clock::now() - start)
+      .count();
+}
+
+}  // namespace bench
@@ -0,0 +1,132 @@
+#include "intrusive_list/buddy_allocator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+
+/*
+ * buddy_allocator throughput and fragmentation. A live set of buffers with
+ * log-uniform sizes between 4 KiB and 1 MiB is churned: each step frees a
+ * random buffer and allocates a new one in its place. glibc malloc runs
+ * the same sequence for comparison. Every quarter of the run the state of
+ * the buddy arena is printed: external fragmentation as reported by
+ * fragmentation(), the largest free block, and internal fragmentation,
+ * the share of handed out bytes lost to rounding up to a power of two.
+ *
+ * usage: buddy_allocator_bench [operations] [live buffers]
+ */
+
+namespace {
+
+struct buffer {
+  void* ptr;
+  size_t size;
+};
+
+struct malloc_heap {
+  void* allocate(size_t size) { return std::malloc(size); }
+  void deallocate(void* ptr, size_t) { std::free(ptr); }
+  void report(size_t) {}
+};
+
+struct buddy_heap {
+  intrusive_list::buddy_allocator& buddy;
+  size_t requested = 0;
+  size_t handed_out = 0;
+
+  void* allocate(size_t size) {
+    void* ptr = buddy.allocate(size);
+    if (ptr) {
+      requested += size;
+      handed_out += buddy.block_size_for(size);
+    }
+    return ptr;
+  }
+
+  void deallocate(void* ptr, size_t size) {
+    buddy.deallocate(ptr, size);
+    requested -= size;
+    handed_out -= buddy.block_size_for(size);
+  }
+
+  void report(size_t step) {
+    std::printf(
+        "  step %9zu: external %.3f, largest free %8zu KiB, "
+        "internal %.3f\n",
+        step, buddy.fragmentation(), buddy.largest_free_block() >> 10,
+        handed_out ? 1.0 - static_cast<double>(requested) / handed_out : 0);
+  }
+};
+
+template <typename Heap>
+void run(const char* name, Heap& heap, const std::vector<size_t>& sizes,
+         const std::vector<size_t>& picks, size_t live) {
+  std::vector<buffer> buffers(live);
+  for (size_t i = 0; i < live; ++i) {
+    buffers[i] = {heap.allocate(sizes[i]), sizes[i]};
+  }
+
+  size_t failed = 0;
+  size_t quarter = picks.size() / 4 ? picks.size() / 4 : 1;
+  double ns = 0;
+  for (size_t begin = 0; begin < picks.size(); begin += quarter) {
+    size_t end = std::min(begin + quarter, picks.size());
+    ns += bench::time_ns([&] {
+      for (size_t i = begin; i < end; ++i) {
+        buffer& b = buffers[picks[i]];
+        if (b.ptr) heap.deallocate(b.ptr, b.size);
+        b.size = sizes[live + i];
+        b.ptr = heap.allocate(b.size);
+        if (!b.ptr) failed++;
+      }
+    });
+    heap.report(end);
+  }
+  for (auto& b : buffers) {
+    if (b.ptr) heap.deallocate(b.ptr, b.size);
+  }
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "%zu live, %zu failed", live,
+                failed);
+  bench::report(name, variant, 2 * picks.size(), ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t ops = bench::size_arg(argc, argv, 1, 1 << 20);
+  size_t live = bench::size_arg(argc, argv, 2, 512);
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> log_size(12, 20);
+  std::vector<size_t> sizes(live + ops);
+  for (auto& size : sizes) {
+    size = static_cast<size_t>(std::exp2(log_size(rng)));
+  }
+  std::vector<size_t> picks(ops);
+  for (auto& pick : picks) pick = rng() % live;
+
+  // Mean buffer is about 180 KiB, give the arena room for twice the mean
+  // live set after rounding, in a power of two.
+  size_t arena_bytes = 1 << 20;
+  while (arena_bytes < live * (512 << 10)) arena_bytes <<= 1;
+  auto arena =
+      static_cast<unsigned char*>(std::aligned_alloc(4096, arena_bytes));
+  std::memset(arena, 0, arena_bytes);
+  intrusive_list::buddy_allocator buddy(arena, arena_bytes, 4096);
+
+  malloc_heap heap;
+  run("malloc", heap, sizes, picks, live);
+  buddy_heap buddy_heap{buddy};
+  run("buddy_allocator", buddy_heap, sizes, picks, live);
+
+  std::free(arena);
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "intrusive_list/free_list_resource.h"
+
+#include <cstdio>
+#include <list>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+
+/*
+ * free_list_resource against the standard pmr resources, driving unchanged
+ * pmr containers:
+ *
+ *  - "map churn": a std::pmr::unordered_map<int, int> of n keys where each
+ *    step erases a random key and inserts a new one;
+ *  - "list + strings": build a std::pmr::list of n std::pmr::strings of 8
+ *    to 200 characters, then destroy it, several rounds.
+ *
+ * usage: free_list_resource_bench [keys] [operations]
+ */
+
+namespace {
+
+void map_churn(const char* name, std::pmr::memory_resource* resource,
+               size_t n, const std::vector<size_t>& picks) {
+  std::pmr::unordered_map<int, int> map(resource);
+  std::vector<int> live(n);
+  for (size_t i = 0; i < n; ++i) {
+    live[i] = static_cast<int>(i);
+    map.emplace(live[i], 0);
+  }
+
+  int next = static_cast<int>(n);
+  double ns = bench::time_ns([&] {
+    for (size_t pick : picks) {
+      map.erase(live[pick]);
+      live[pick] = next++;
+      map.emplace(live[pick], 0);
+    }
+  });
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "map churn %zu keys", n);
+  bench::report(name, variant, picks.size(), ns);
+}
+
+void list_strings(const char* name, std::pmr::memory_resource* resource,
+                  size_t n, const std::vector<size_t>& lengths) {
+  constexpr int kRounds = 8;
+  double ns = bench::time_ns([&] {
+    for (int round = 0; round < kRounds; ++round) {
+      std::pmr::list<std::pmr::string> list(resource);
+      for (size_t i = 0; i < n; ++i) list.emplace_back(lengths[i], 'x');
+      bench::do_not_optimize(list.back().size());
+    }
+  });
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "list + strings %zu", n);
+  bench::report(name, variant, kRounds * n, ns);
+}
+
+template <typename Resource>
+void print_stats(Resource&) {}
+
+template <bool thread_safe>
+void print_stats(intrusive_list::free_list_resource<thread_safe>& resource) {
+  auto stats = resource.stats();
+  std::printf("  %zu hits, %zu refills, %zu KiB held\n", stats.hits,
+              stats.refills, stats.bytes_held >> 10);
+}
+
+template <typename Resource>
+void run(const char* name, size_t n, const std::vector<size_t>& picks,
+         const std::vector<size_t>& lengths) {
+  {
+    Resource resource;
+    map_churn(name, &resource, n, picks);
+    print_stats(resource);
+  }
+  {
+    Resource resource;
+    list_strings(name, &resource, n, lengths);
+    print_stats(resource);
+  }
+}
+
+// Adapts new_delete_resource() to the owning interface run() expects.
+class new_delete_resource : public std::pmr::memory_resource {
+  void* do_allocate(size_t bytes, size_t alignment) override {
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 16);
+  size_t ops = bench::size_arg(argc, argv, 2, 1 << 21);
+
+  std::mt19937 rng(1);
+  std::vector<size_t> picks(ops);
+  for (auto& pick : picks) pick = rng() % n;
+  std::vector<size_t> lengths(n);
+  for (auto& length : lengths) length = 8 + rng() % 193;
+
+  run<new_delete_resource>("new_delete_resource", n, picks, lengths);
+  run<std::pmr::unsynchronized_pool_resource>("unsync pool", n, picks,
+                                              lengths);
+  run<std::pmr::synchronized_pool_resource>("sync pool", n, picks, lengths);
+  run<intrusive_list::free_list_resource<false>>("free_list_resource", n,
+                                                 picks, lengths);
+  run<intrusive_list::free_list_resource<true>>("free_list_resource mt", n,
+                                                picks, lengths);
+  return 0;
+}
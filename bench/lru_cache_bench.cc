@@ -0,0 +1,154 @@
+#include "intrusive_list/lru_cache.h"
+
+#include <cstdio>
+#include <list>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/forward_list.h"
+#include "intrusive_list/list.h"
+
+/*
+ * lru_cache against the two hand-rolled caches it replaces: std::list plus
+ * std::unordered_map of list iterators, and an intrusive list plus
+ * std::unordered_map of item pointers. Every operation looks a key up and
+ * inserts it on a miss, evicting the least recently used item. Keys are
+ * skewed towards small values out of four times the capacity; the hit ratio
+ * is printed at the end.
+ *
+ * usage: lru_cache_bench [operations] [capacity]
+ */
+
+namespace {
+
+struct bench_node {
+  bench_node* next;
+  bench_node* prev;
+};
+
+struct bench_item {
+  int key;
+  bench_node node;
+  intrusive_list::forward_list_node index_node;
+};
+
+struct key_of {
+  int operator()(const bench_item& item) const { return item.key; }
+};
+
+using intrusive_cache =
+    intrusive_list::lru_cache<bench_item, &bench_item::node,
+                              &bench_item::index_node, key_of>;
+
+class std_cache {
+ public:
+  explicit std_cache(size_t capacity) : capacity_(capacity) {
+    index_.reserve(capacity + 1);
+  }
+
+  bool find(int key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return false;
+    order_.splice(order_.begin(), order_, it->second);
+    return true;
+  }
+
+  void insert(int key) {
+    order_.push_front(key);
+    index_.emplace(key, order_.begin());
+    if (order_.size() > capacity_) {
+      index_.erase(order_.back());
+      order_.pop_back();
+    }
+  }
+
+ private:
+  std::list<int> order_;
+  std::unordered_map<int, std::list<int>::iterator> index_;
+  size_t capacity_;
+};
+
+class map_indexed_cache {
+ public:
+  explicit map_indexed_cache(size_t capacity) : capacity_(capacity) {
+    index_.reserve(capacity + 1);
+  }
+
+  bench_item* find(int key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) return nullptr;
+    order_.remove_if_exists(*it->second);
+    order_.push_front(*it->second);
+    return it->second;
+  }
+
+  void insert(bench_item& item) {
+    index_.emplace(item.key, &item);
+    order_.push_front(item);
+    if (order_.size() > capacity_) {
+      index_.erase(order_.back().key);
+      order_.pop_back();
+    }
+  }
+
+ private:
+  intrusive_list::list<bench_item, &bench_item::node, true> order_;
+  std::unordered_map<int, bench_item*> index_;
+  size_t capacity_;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t ops = bench::size_arg(argc, argv, 1, 1 << 22);
+  size_t capacity = bench::size_arg(argc, argv, 2, 1 << 16);
+  size_t key_space = capacity * 4;
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  std::vector<int> keys(ops);
+  for (auto& key : keys) {
+    double u = uniform(rng);
+    key = static_cast<int>(u * u * static_cast<double>(key_space));
+  }
+  std::vector<bench_item> items(key_space);
+  for (size_t i = 0; i < key_space; ++i) items[i].key = static_cast<int>(i);
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "capacity %zu", capacity);
+
+  size_t hits = 0;
+  double ns = bench::time_ns([&] {
+    std_cache cache(capacity);
+    for (int key : keys) {
+      if (cache.find(key)) {
+        hits++;
+      } else {
+        cache.insert(key);
+      }
+    }
+  });
+  bench::report("std::list + map", variant, ops, ns);
+
+  ns = bench::time_ns([&] {
+    map_indexed_cache cache(capacity);
+    for (int key : keys) {
+      if (!cache.find(key)) cache.insert(items[key]);
+    }
+  });
+  bench::report("list + std map index", variant, ops, ns);
+
+  ns = bench::time_ns([&] {
+    intrusive_cache cache(capacity);
+    for (int key : keys) {
+      if (!cache.find(key)) cache.insert(items[key]);
+    }
+  });
+  bench::report("lru_cache", variant, ops, ns);
+
+  std::printf("hit ratio %.2f\n",
+              static_cast<double>(hits) / static_cast<double>(ops));
+  return 0;
+}
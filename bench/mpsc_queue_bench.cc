@@ -0,0 +1,111 @@
+#include "intrusive_list/mpsc_queue.h"
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/queue.h"
+
+/*
+ * mpsc_queue against an intrusive queue behind a std::mutex, the wrapper it
+ * replaces. N producers push their share of the items while one consumer
+ * drains them; reported time is per item, from the release of all threads
+ * until the consumer has seen the last item.
+ *
+ * usage: mpsc_queue_bench [items] [max producers]
+ */
+
+namespace {
+
+struct bench_item {
+  int value;
+  intrusive_list::forward_list_node node;
+};
+
+using lock_free_queue =
+    intrusive_list::mpsc_queue<bench_item, &bench_item::node>;
+
+class locked_queue {
+ public:
+  void push(bench_item& item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(item);
+  }
+
+  bench_item* pop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) return nullptr;
+    auto item = &queue_.front();
+    queue_.pop_front();
+    return item;
+  }
+
+ private:
+  std::mutex mutex_;
+  intrusive_list::queue<bench_item, &bench_item::node> queue_;
+};
+
+template <typename Queue>
+void consume_one_by_one(Queue& queue, size_t total) {
+  size_t received = 0;
+  while (received < total) {
+    if (auto item = queue.pop()) {
+      bench::do_not_optimize(item->value);
+      received++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void consume_batches(lock_free_queue& queue, size_t total) {
+  size_t received = 0;
+  while (received < total) {
+    auto batch = queue.pop_all();
+    if (batch.empty()) std::this_thread::yield();
+    for (auto& item : batch) {
+      bench::do_not_optimize(item.value);
+      received++;
+    }
+  }
+}
+
+template <typename Queue, typename Consume>
+void run(const char* name, int producers, std::vector<bench_item>& items,
+         Consume consume) {
+  Queue queue;
+  size_t per_producer = items.size() / producers;
+  size_t total = per_producer * producers;
+  double ns = bench::run_threads(producers + 1, [&](int i) {
+    if (i == producers) {
+      consume(queue, total);
+      return;
+    }
+    for (size_t k = 0; k < per_producer; ++k) {
+      queue.push(items[i * per_producer + k]);
+    }
+  });
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "%d producers", producers);
+  bench::report(name, variant, total, ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 20);
+  int max_producers = static_cast<int>(bench::size_arg(argc, argv, 2, 64));
+  std::vector<bench_item> items(n);
+
+  for (int p = 1; p <= max_producers; p *= 2) {
+    run<locked_queue>("mutex queue pop", p, items,
+                      consume_one_by_one<locked_queue>);
+    run<lock_free_queue>("mpsc_queue pop", p, items,
+                         consume_one_by_one<lock_free_queue>);
+    run<lock_free_queue>("mpsc_queue pop_all", p, items, consume_batches);
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include "intrusive_list/object_pool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory_resource>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+
+/*
+ * object_pool against new/delete and std::pmr::unsynchronized_pool_resource
+ * for one 64 byte object type. "batch" allocates n objects and frees them
+ * in shuffled order, several rounds; "churn" keeps n objects live and
+ * replaces a random one per operation.
+ *
+ * usage: object_pool_bench [objects] [operations]
+ */
+
+namespace {
+
+struct bench_object {
+  explicit bench_object(size_t v) : value(v) {}
+  size_t value;
+  char payload[56];
+};
+
+struct new_delete {
+  bench_object* create(size_t v) { return new bench_object(v); }
+  void destroy(bench_object* object) { delete object; }
+};
+
+struct pmr_pool {
+  std::pmr::unsynchronized_pool_resource resource;
+  std::pmr::polymorphic_allocator<bench_object> allocator{&resource};
+
+  bench_object* create(size_t v) {
+    auto object = allocator.allocate(1);
+    return new (object) bench_object(v);
+  }
+  void destroy(bench_object* object) {
+    object->~bench_object();
+    allocator.deallocate(object, 1);
+  }
+};
+
+struct intrusive_pool {
+  intrusive_list::object_pool<bench_object> pool{256};
+
+  bench_object* create(size_t v) { return pool.create(v); }
+  void destroy(bench_object* object) { pool.destroy(object); }
+};
+
+template <typename Allocator>
+void run(const char* name, size_t n, size_t ops,
+         const std::vector<size_t>& order, const std::vector<size_t>& picks) {
+  Allocator allocator;
+  std::vector<bench_object*> objects(n);
+  char variant[64];
+
+  constexpr int kRounds = 8;
+  double ns = bench::time_ns([&] {
+    for (int round = 0; round < kRounds; ++round) {
+      for (size_t i = 0; i < n; ++i) objects[i] = allocator.create(i);
+      for (size_t i : order) allocator.destroy(objects[i]);
+    }
+  });
+  std::snprintf(variant, sizeof(variant), "batch %zu", n);
+  bench::report(name, variant, 2 * kRounds * n, ns);
+
+  for (size_t i = 0; i < n; ++i) objects[i] = allocator.create(i);
+  ns = bench::time_ns([&] {
+    for (size_t pick : picks) {
+      allocator.destroy(objects[pick]);
+      objects[pick] = allocator.create(pick);
+    }
+  });
+  std::snprintf(variant, sizeof(variant), "churn %zu live", n);
+  bench::report(name, variant, 2 * ops, ns);
+  for (auto object : objects) allocator.destroy(object);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 16);
+  size_t ops = bench::size_arg(argc, argv, 2, 1 << 22);
+
+  std::mt19937_64 rng(1);
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i) order[i] = i;
+  std::shuffle(order.begin(), order.end(), rng);
+  std::vector<size_t> picks(ops);
+  for (auto& pick : picks) pick = rng() % n;
+
+  run<new_delete>("new/delete", n, ops, order, picks);
+  run<pmr_pool>("pmr unsync pool", n, ops, order, picks);
+  run<intrusive_pool>("object_pool", n, ops, order, picks);
+  return 0;
+}
@@ -0,0 +1,89 @@
+#include "intrusive_list/prefetch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/list.h"
+
+/*
+ * for_each_prefetch at distances 0 to max distance against a plain
+ * range-for, on a list linked in shuffled order so that every hop misses
+ * the cache. Items span two cache lines, the hook and a key in the first
+ * and the value f reads in the second. f mixes key and value work times,
+ * standing in for the per-item work of a real loop. The default of 256
+ * rounds is enough to show the gain; at 16 or below there is none, as
+ * the walk is bound by the lookahead's own pointer chasing.
+ *
+ * usage: prefetch_bench [items] [max distance] [work]
+ */
+
+namespace {
+
+struct bench_node {
+  bench_node* next;
+  bench_node* prev;
+};
+
+struct bench_item {
+  bench_node node;
+  uint64_t key;
+  char payload[104];
+  uint64_t value;
+};
+
+using item_list = intrusive_list::list<bench_item, &bench_item::node>;
+
+struct visitor {
+  int work;
+  uint64_t sum = 0;
+
+  void operator()(const bench_item& item) {
+    uint64_t x = item.key ^ item.value;
+    for (int i = 0; i < work; ++i) x = x * 0x9e3779b97f4a7c15ull + i;
+    sum += x;
+  }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  constexpr int kRepeats = 3;
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 22);
+  size_t max_distance = bench::size_arg(argc, argv, 2, 16);
+  int work = static_cast<int>(bench::size_arg(argc, argv, 3, 256));
+
+  std::vector<bench_item> items(n);
+  for (size_t i = 0; i < n; ++i) items[i].key = items[i].value = i;
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937_64 rng(1);
+  std::shuffle(order.begin(), order.end(), rng);
+  item_list list;
+  for (size_t i : order) list.push_back(items[i]);
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "range-for, work %d", work);
+  double ns = bench::best_ns(kRepeats, [&] {
+    visitor f{work};
+    for (auto& item : list) f(item);
+    bench::do_not_optimize(f.sum);
+  });
+  bench::report("for_each", variant, n, ns);
+
+  for (size_t distance = 0; distance <= max_distance; ++distance) {
+    ns = bench::best_ns(kRepeats, [&] {
+      visitor f{work};
+      intrusive_list::for_each_prefetch(list, distance, f);
+      bench::do_not_optimize(f.sum);
+    });
+    std::snprintf(variant, sizeof(variant), "distance %zu, work %d", distance,
+                  work);
+    bench::report("for_each_prefetch", variant, n, ns);
+  }
+  return 0;
+}
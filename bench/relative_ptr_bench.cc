@@ -0,0 +1,137 @@
+#include "intrusive_list/relative_ptr.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <new>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/forward_list.h"
+#include "intrusive_list/list.h"
+
+/*
+ * Memory and traversal cost of pointer hooks against 32-bit relative hooks.
+ * Each item is an int payload plus one hook; n items and the list head
+ * share one allocation, as relative hooks require. The list is linked in
+ * allocation order ("sequential") and in shuffled order ("shuffled"), then
+ * walked summing the payloads, best of five walks.
+ *
+ * usage: relative_ptr_bench [items]
+ */
+
+namespace {
+
+struct pointer_node {
+  pointer_node* next;
+  pointer_node* prev;
+};
+
+struct pointer_item {
+  int value;
+  pointer_node node;
+};
+
+struct relative_item {
+  int value;
+  intrusive_list::relative_list_node node;
+};
+
+struct pointer_forward_item {
+  int value;
+  intrusive_list::forward_list_node node;
+};
+
+struct relative_forward_item {
+  int value;
+  intrusive_list::relative_forward_list_node node;
+};
+
+// The list head followed by n items in one allocation.
+template <typename List, typename Item>
+class arena {
+ public:
+  explicit arena(size_t n)
+      : storage_(::operator new(items_offset() + n * sizeof(Item))) {
+    new (storage_) List();
+    for (size_t i = 0; i < n; ++i) {
+      new (items() + i) Item{static_cast<int>(i), {}};
+    }
+  }
+  ~arena() {
+    list().~List();
+    ::operator delete(storage_);
+  }
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  size_t bytes(size_t n) const { return items_offset() + n * sizeof(Item); }
+  List& list() { return *static_cast<List*>(storage_); }
+  Item* items() {
+    return reinterpret_cast<Item*>(static_cast<char*>(storage_) +
+                                   items_offset());
+  }
+
+ private:
+  static constexpr size_t items_offset() {
+    return (sizeof(List) + alignof(Item) - 1) / alignof(Item) * alignof(Item);
+  }
+
+  void* storage_;
+};
+
+template <typename List, typename Item>
+void run(const char* name, const std::vector<size_t>& order,
+         const char* layout) {
+  size_t n = order.size();
+  arena<List, Item> memory(n);
+  List& list = memory.list();
+  for (size_t i : order) list.push_front(memory.items()[i]);
+
+  constexpr int kRepeats = 5;
+  double ns = bench::best_ns(kRepeats, [&] {
+    long sum = 0;
+    for (const auto& item : list) sum += item.value;
+    bench::do_not_optimize(sum);
+  });
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "%s %zuB/item %zuMiB", layout,
+                sizeof(Item), memory.bytes(n) >> 20);
+  bench::report(name, variant, n, ns);
+}
+
+template <typename List, typename Item>
+void run_both(const char* name, const std::vector<size_t>& sequential,
+              const std::vector<size_t>& shuffled) {
+  run<List, Item>(name, sequential, "sequential");
+  run<List, Item>(name, shuffled, "shuffled");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 22);
+
+  // push_front reverses the order, so link back to front to walk forward.
+  std::vector<size_t> sequential(n);
+  std::iota(sequential.rbegin(), sequential.rend(), 0);
+  std::vector<size_t> shuffled = sequential;
+  std::mt19937_64 rng(1);
+  std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+  run_both<intrusive_list::list<pointer_item, &pointer_item::node>,
+           pointer_item>("list pointer", sequential, shuffled);
+  run_both<intrusive_list::list<relative_item, &relative_item::node>,
+           relative_item>("list relative", sequential, shuffled);
+  run_both<intrusive_list::forward_list<pointer_forward_item,
+                                        &pointer_forward_item::node>,
+           pointer_forward_item>("forward_list pointer", sequential,
+                                 shuffled);
+  run_both<intrusive_list::forward_list<relative_forward_item,
+                                        &relative_forward_item::node>,
+           relative_forward_item>("forward_list relative", sequential,
+                                  shuffled);
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include "intrusive_list/slab_allocator.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/mpsc_queue.h"
+
+/*
+ * slab_allocator throughput against glibc malloc at 1 to 64 threads.
+ *
+ * "local": every thread allocates a batch of 64 objects and frees it again.
+ * "remote": threads are paired, one allocates and passes the objects
+ * through an mpsc_queue to the other, which frees them, so every free is a
+ * cross-thread free. Reported time is per allocate or free over all
+ * threads.
+ *
+ * usage: slab_allocator_bench [operations per thread] [max threads]
+ */
+
+namespace {
+
+struct bench_object {
+  uint64_t payload[5];
+  intrusive_list::forward_list_node node;
+};
+
+using allocator_type = intrusive_list::slab_allocator<bench_object>;
+using object_queue =
+    intrusive_list::mpsc_queue<bench_object, &bench_object::node>;
+
+constexpr size_t kBatch = 64;
+
+struct malloc_cache {
+  bench_object* allocate() {
+    return static_cast<bench_object*>(std::malloc(sizeof(bench_object)));
+  }
+  void deallocate(bench_object* object) { std::free(object); }
+};
+
+template <typename MakeCache>
+double local(int threads, size_t ops, MakeCache make_cache) {
+  return bench::run_threads(threads, [&](int) {
+    auto cache = make_cache();
+    bench_object* batch[kBatch];
+    for (size_t done = 0; done < ops; done += kBatch) {
+      for (auto& object : batch) object = cache->allocate();
+      for (auto object : batch) cache->deallocate(object);
+    }
+  });
+}
+
+template <typename MakeCache>
+double remote(int threads, size_t ops, MakeCache make_cache) {
+  std::vector<object_queue> queues(threads / 2);
+  return bench::run_threads(threads, [&](int i) {
+    auto cache = make_cache();
+    object_queue& queue = queues[i / 2];
+    if (i % 2 == 0) {
+      for (size_t done = 0; done < ops; ++done) {
+        queue.push(*new (cache->allocate()) bench_object{});
+      }
+      return;
+    }
+    for (size_t done = 0; done < ops;) {
+      if (auto object = queue.pop()) {
+        cache->deallocate(object);
+        done++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+}
+
+void report(const char* name, const char* workload, int threads, size_t ops,
+            double ns) {
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "%s %d threads", workload, threads);
+  // every object is allocated and freed once
+  bench::report(name, variant, 2 * ops, ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t ops = bench::size_arg(argc, argv, 1, 1 << 20);
+  int max_threads = static_cast<int>(bench::size_arg(argc, argv, 2, 64));
+  ops = (ops + kBatch - 1) / kBatch * kBatch;
+
+  auto make_malloc = [] { return std::make_unique<malloc_cache>(); };
+  for (int threads = 1; threads <= max_threads; threads *= 2) {
+    allocator_type allocator;
+    auto make_slab = [&allocator] {
+      return std::make_unique<allocator_type::thread_cache>(allocator);
+    };
+
+    report("malloc", "local", threads, threads * ops,
+           local(threads, ops, make_malloc));
+    report("slab_allocator", "local", threads, threads * ops,
+           local(threads, ops, make_slab));
+    if (threads < 2) continue;
+    // half the threads allocate, each object is freed by its partner
+    size_t objects = threads / 2 * ops;
+    report("malloc", "remote", threads, objects,
+           remote(threads, ops, make_malloc));
+    report("slab_allocator", "remote", threads, objects,
+           remote(threads, ops, make_slab));
+  }
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "intrusive_list/soa_list.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list/list.h"
+
+/*
+ * soa_list against list with a member hook. Both hold the same 48 byte
+ * items, the member hook makes them 64 bytes while soa_list keeps its 8
+ * bytes of links per item in separate arrays. The items are linked in
+ * shuffled order, then:
+ *
+ *  - "walk": step an iterator over the list without dereferencing it;
+ *  - "walk + read": the same, reading a field of every item;
+ *  - "rotate_left": rotate the list n times;
+ *  - "splice 16": move the list to a second one in runs of 16 items by
+ *    splice(), and back.
+ *
+ * usage: soa_list_bench [items]
+ * e.g. soa_list_bench 100000000 needs about 7 GiB.
+ */
+
+namespace {
+
+struct bench_node {
+  bench_node* next;
+  bench_node* prev;
+};
+
+struct member_item {
+  uint64_t value;
+  char payload[40];
+  bench_node node;
+};
+
+struct soa_item {
+  uint64_t value;
+  char payload[40];
+};
+
+struct member_lists {
+  using list_type = intrusive_list::list<member_item, &member_item::node>;
+
+  explicit member_lists(size_t n) : items(n) {}
+
+  std::vector<member_item> items;
+  list_type a;
+  list_type b;
+};
+
+struct soa_lists {
+  using list_type = intrusive_list::soa_list<soa_item>;
+
+  explicit soa_lists(size_t n)
+      : items(n), links(n), a(items.data(), links), b(items.data(), links) {}
+
+  std::vector<soa_item> items;
+  intrusive_list::soa_links<> links;
+  list_type a;
+  list_type b;
+};
+
+constexpr size_t kChunk = 16;
+
+template <typename List>
+void move_chunks(List& from, List& to) {
+  while (!from.empty()) {
+    auto last = from.begin();
+    for (size_t k = 0; k < kChunk && last != from.end(); ++k) ++last;
+    to.splice(to.end(), from, from.begin(), last);
+  }
+}
+
+template <typename Lists>
+void run(const char* name, const std::vector<size_t>& order) {
+  constexpr int kRepeats = 3;
+  size_t n = order.size();
+  Lists lists(n);
+  for (size_t i = 0; i < n; ++i) lists.items[i].value = i;
+  for (size_t i : order) lists.a.push_back(lists.items[i]);
+  auto& list = lists.a;
+
+  double ns = bench::best_ns(kRepeats, [&] {
+    size_t count = 0;
+    for (auto it = list.begin(); it != list.end(); ++it) count++;
+    bench::do_not_optimize(count);
+  });
+  bench::report(name, "walk", n, ns);
+
+  ns = bench::best_ns(kRepeats, [&] {
+    uint64_t sum = 0;
+    for (auto it = list.begin(); it != list.end(); ++it) sum += it->value;
+    bench::do_not_optimize(sum);
+  });
+  bench::report(name, "walk + read", n, ns);
+
+  ns = bench::time_ns([&] {
+    for (size_t i = 0; i < n; ++i) list.rotate_left();
+  });
+  bench::report(name, "rotate_left", n, ns);
+
+  ns = bench::time_ns([&] {
+    move_chunks(lists.a, lists.b);
+    move_chunks(lists.b, lists.a);
+  });
+  bench::report(name, "splice 16", 2 * n, ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t n = bench::size_arg(argc, argv, 1, 1 << 20);
+
+  std::vector<size_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::mt19937_64 rng(1);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  std::printf("%zu items, %zu MiB with member hooks, %zu MiB with soa_list\n",
+              n, n * sizeof(member_item) >> 20,
+              n * (sizeof(soa_item) + 2 * sizeof(uint32_t)) >> 20);
+  run<member_lists>("list member hook", order);
+  run<soa_lists>("soa_list", order);
+  return 0;
+}
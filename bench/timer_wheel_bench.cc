@@ -0,0 +1,130 @@
+#include "intrusive_list/timer_wheel.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+
+/*
+ * timer_wheel against a std::multimap keyed by expiry tick, the structure
+ * it replaces. For each timer count: arm every timer, re-arm every timer
+ * further out as an idle connection would on activity, then advance until
+ * all of them have expired. Expiries are spread over 2^20 ticks.
+ *
+ * usage: timer_wheel_bench [timers...], 1M and 10M by default
+ */
+
+namespace {
+
+struct bench_node {
+  bench_node* next;
+  bench_node* prev;
+};
+
+struct wheel_timer {
+  uint64_t expires;
+  bench_node node;
+};
+
+using wheel = intrusive_list::timer_wheel<wheel_timer, &wheel_timer::node,
+                                          &wheel_timer::expires>;
+
+struct map_timer;
+using timer_map = std::multimap<uint64_t, map_timer*>;
+
+struct map_timer {
+  timer_map::iterator position;
+  bool armed = false;
+};
+
+class map_wheel {
+ public:
+  void schedule(map_timer& timer, uint64_t expires) {
+    if (timer.armed) timers_.erase(timer.position);
+    timer.position = timers_.emplace(expires, &timer);
+    timer.armed = true;
+  }
+
+  size_t advance(uint64_t now) {
+    size_t expired = 0;
+    while (!timers_.empty() && timers_.begin()->first <= now) {
+      timers_.begin()->second->armed = false;
+      timers_.erase(timers_.begin());
+      expired++;
+    }
+    return expired;
+  }
+
+ private:
+  timer_map timers_;
+};
+
+constexpr uint64_t kSpread = uint64_t(1) << 20;
+
+void run(size_t n) {
+  std::mt19937_64 rng(n);
+  std::vector<uint64_t> first(n);
+  std::vector<uint64_t> second(n);
+  for (size_t i = 0; i < n; ++i) {
+    first[i] = 1 + rng() % kSpread;
+    second[i] = first[i] + rng() % kSpread;
+  }
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "%zu timers", n);
+
+  {
+    std::vector<map_timer> timers(n);
+    map_wheel map;
+    double ns = bench::time_ns([&] {
+      for (size_t i = 0; i < n; ++i) map.schedule(timers[i], first[i]);
+    });
+    bench::report("multimap schedule", variant, n, ns);
+    ns = bench::time_ns([&] {
+      for (size_t i = 0; i < n; ++i) map.schedule(timers[i], second[i]);
+    });
+    bench::report("multimap rearm", variant, n, ns);
+    size_t expired = 0;
+    ns = bench::time_ns([&] {
+      for (uint64_t tick = 0; expired < n; tick += 64) {
+        expired += map.advance(tick);
+      }
+    });
+    bench::report("multimap expire", variant, n, ns);
+  }
+
+  {
+    std::vector<wheel_timer> timers(n);
+    wheel wheel;
+    double ns = bench::time_ns([&] {
+      for (size_t i = 0; i < n; ++i) wheel.schedule(timers[i], first[i]);
+    });
+    bench::report("timer_wheel schedule", variant, n, ns);
+    ns = bench::time_ns([&] {
+      for (size_t i = 0; i < n; ++i) wheel.schedule(timers[i], second[i]);
+    });
+    bench::report("timer_wheel rearm", variant, n, ns);
+    size_t expired = 0;
+    ns = bench::time_ns([&] {
+      for (uint64_t tick = 0; expired < n; tick += 64) {
+        expired += wheel.advance(tick, [](wheel_timer& timer) {
+          bench::do_not_optimize(timer.expires);
+        });
+      }
+    });
+    bench::report("timer_wheel expire", variant, n, ns);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    run(1000000);
+    run(10000000);
+  }
+  for (int i = 1; i < argc; ++i) run(bench::size_arg(argc, argv, i, 0));
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "intrusive_list/tlsf.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+
+/*
+ * Latency distribution of tlsf_allocator against glibc malloc. A live set
+ * of blocks with log-uniform sizes between 16 bytes and 64 KiB is churned:
+ * each step frees a random block and allocates a new one in its place.
+ * Every allocate and free is timed on its own, so the figures include the
+ * cost of reading the clock.
+ *
+ * usage: tlsf_bench [operations] [live blocks]
+ */
+
+namespace {
+
+struct malloc_heap {
+  void* allocate(size_t size) { return std::malloc(size); }
+  void deallocate(void* ptr) { std::free(ptr); }
+};
+
+template <typename Heap>
+void run(const char* name, Heap& heap, const std::vector<size_t>& sizes,
+         const std::vector<size_t>& picks, size_t live) {
+  std::vector<void*> blocks(live);
+  for (size_t i = 0; i < live; ++i) blocks[i] = heap.allocate(sizes[i]);
+
+  std::vector<double> alloc_ns;
+  std::vector<double> free_ns;
+  alloc_ns.reserve(picks.size());
+  free_ns.reserve(picks.size());
+  size_t failed = 0;
+  for (size_t i = 0; i < picks.size(); ++i) {
+    void*& block = blocks[picks[i]];
+    if (block) {
+      free_ns.push_back(bench::time_ns([&] { heap.deallocate(block); }));
+    }
+    size_t size = sizes[live + i];
+    alloc_ns.push_back(bench::time_ns([&] { block = heap.allocate(size); }));
+    if (!block) failed++;
+  }
+  for (auto block : blocks) {
+    if (block) heap.deallocate(block);
+  }
+
+  char variant[64];
+  std::snprintf(variant, sizeof(variant), "allocate, %zu failed", failed);
+  bench::report_latency(name, variant, alloc_ns);
+  bench::report_latency(name, "free", free_ns);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t ops = bench::size_arg(argc, argv, 1, 1 << 20);
+  size_t live = bench::size_arg(argc, argv, 2, 4096);
+
+  std::mt19937_64 rng(1);
+  std::uniform_real_distribution<double> log_size(4, 16);
+  std::vector<size_t> sizes(live + ops);
+  for (auto& size : sizes) {
+    size = static_cast<size_t>(std::exp2(log_size(rng)));
+  }
+  std::vector<size_t> picks(ops);
+  for (auto& pick : picks) pick = rng() % live;
+
+  // Four times the mean live size leaves room for fragmentation.
+  size_t arena_bytes = live * 8192 * 4;
+  std::unique_ptr<unsigned char[]> arena(new unsigned char[arena_bytes]);
+  // Fault the arena in so that page faults do not land in the samples.
+  std::memset(arena.get(), 0, arena_bytes);
+  intrusive_list::tlsf_allocator tlsf(arena.get(), arena_bytes);
+  malloc_heap heap;
+
+  run("malloc", heap, sizes, picks, live);
+  run("tlsf_allocator", tlsf, sizes, picks, live);
+  return 0;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace intrusive_list::internal {
+
+/*
+ * Atomic access to the plain pointer fields of the ordinary hooks, so that the
+ * lock-free containers can share forward_list_node with forward_list.
+ *
+ * GCC and Clang provide builtins that operate on any naturally aligned
+ * pointer; elsewhere fall back to viewing the field as a std::atomic, which
+ * has the same size and representation on all supported targets.
+ */
+
+template <typename P>
+static inline P atomic_load(P const *ptr, std::memory_order order) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(ptr, static_cast<int>(order));
+#else
+  static_assert(sizeof(std::atomic<P>) == sizeof(P));
+  return reinterpret_cast<const std::atomic<P> *>(ptr)->load(order);
+#endif
+}
+
+template <typename P>
+static inline void atomic_store(P *ptr, P value, std::memory_order order) {
+#if defined(__GNUC__) || defined(__clang__)
+  __atomic_store_n(ptr, value, static_cast<int>(order));
+#else
+  static_assert(sizeof(std::atomic<P>) == sizeof(P));
+  reinterpret_cast<std::atomic<P> *>(ptr)->store(value, order);
+#endif
+}
+
+/**
+ * tagged_pointer - pack a pointer and a modification counter in one word
+ *
+ * Lock-free containers bump the tag on every update so that a CAS against a
+ * head that was popped and pushed back in the meantime (ABA) fails. On 64-bit
+ * targets the pointer is assumed to fit in the low 48 bits, which holds for
+ * user-space addresses on x86-64 and AArch64 unless 5-level paging or pointer
+ * tagging is in use. On 32-bit targets the tag takes the upper 32 bits.
+ */
+template <typename Node>
+struct tagged_pointer {
+  using word = uint64_t;
+  static constexpr int kPointerBits = sizeof(void *) == 8 ? 48 : 32;
+  static constexpr word kPointerMask = (word(1) << kPointerBits) - 1;
+
+  static_assert(sizeof(void *) <= sizeof(word));
+  static_assert(std::atomic<word>::is_always_lock_free);
+
+  static inline word pack(Node *node, word tag) {
+    return static_cast<word>(reinterpret_cast<uintptr_t>(node)) |
+           (tag << kPointerBits);
+  }
+
+  static inline Node *pointer(word w) {
+    return reinterpret_cast<Node *>(static_cast<uintptr_t>(w & kPointerMask));
+  }
+
+  static inline word next_tag(word w) { return (w >> kPointerBits) + 1; }
+};
+
+}  // namespace intrusive_list::internal
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+
+#include "atomic.h"
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+
+/**
+ * atomic_stack lock-free LIFO (Treiber stack).
+ *
+ * Uses forward_list_node hooks, so it has the shape of forward_list's
+ * push_front/pop_front but every operation is a single CAS on the head and
+ * is safe from any number of threads. The head carries a modification tag
+ * (see internal::tagged_pointer) to defeat ABA.
+ *
+ * pop() may read the hook of an item that another thread has just popped,
+ * so items must stay readable while they can be in the stack, as is the case
+ * for object pools that never return memory while in use.
+ */
+template <typename T, forward_list_node T::*node_field>
+class atomic_stack {
+  using Tagged = internal::tagged_pointer<forward_list_node>;
+  using word = typename Tagged::word;
+
+  std::atomic<word> head_;
+
+ public:
+  atomic_stack() noexcept : head_(Tagged::pack(nullptr, 0)) {}
+
+  atomic_stack(const atomic_stack &) = delete;
+  atomic_stack &operator=(const atomic_stack &) = delete;
+
+  /**
+   * insert item at the top of stack.
+   * @param item item to insert in stack.
+   */
+  void push(T &item) { push_chain(item, item); }
+
+  /**
+   * insert a prebuilt chain at the top of stack with one CAS.
+   * @param first top item of the chain
+   * @param last bottom item of the chain, reached from first through the
+   * hooks; its hook is overwritten.
+   */
+  void push_chain(T &first, T &last) {
+    forward_list_node *first_node = get_node(&first);
+    forward_list_node *last_node = get_node(&last);
+    word old = head_.load(std::memory_order_relaxed);
+    do {
+      internal::atomic_store(&last_node->next, Tagged::pointer(old),
+                             std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(
+        old, Tagged::pack(first_node, Tagged::next_tag(old)),
+        std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  /**
+   * remove the top item of stack.
+   * @return top item, or nullptr if the stack is empty.
+   */
+  T *pop() {
+    word old = head_.load(std::memory_order_acquire);
+    for (;;) {
+      forward_list_node *top = Tagged::pointer(old);
+      if (top == nullptr) return nullptr;
+      // May be stale if top was popped concurrently, the tag makes the CAS
+      // fail in that case.
+      forward_list_node *next =
+          internal::atomic_load(&top->next, std::memory_order_relaxed);
+      if (head_.compare_exchange_weak(old,
+                                      Tagged::pack(next, Tagged::next_tag(old)),
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire)) {
+        return get_owner(top);
+      }
+    }
+  }
+
+  /**
+   * remove all items with one atomic operation.
+   * @return the removed items, top first
+   */
+  forward_list<T, node_field> exchange_all() {
+    word old = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(
+        old, Tagged::pack(nullptr, Tagged::next_tag(old)),
+        std::memory_order_acquire, std::memory_order_relaxed)) {
+    }
+    return forward_list<T, node_field>(Tagged::pointer(old));
+  }
+
+  /**
+   * check if the stack is empty, the answer may be stale immediately.
+   * @return true if stack is empty.
+   */
+  bool empty() const {
+    return Tagged::pointer(head_.load(std::memory_order_relaxed)) == nullptr;
+  }
+
+ private:
+  static inline constexpr forward_list_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(forward_list_node *member) {
+    return internal::owner_of(member, node_field);
+  }
+};
+
+}  // namespace intrusive_list
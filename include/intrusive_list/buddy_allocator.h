@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "common.h"
+#include "list.h"
+
+namespace intrusive_list {
+
+/**
+ * buddy_allocator binary buddy allocator over a caller-provided arena.
+ *
+ * Blocks are min_block << order bytes and aligned to their size relative to
+ * the start of the arena. Each free block holds a list hook in its own
+ * memory and sits in the list of its order; a bitmap with one bit per block
+ * and order tells whether a block is free at that order. Splitting pops one
+ * block and pushes its upper halves, and freeing merges with the buddy for
+ * as long as the buddy's bit is set, unlinking it in O(1) with
+ * remove_if_exists(). Both are O(log n) in the number of orders.
+ *
+ * The bitmap is the only memory allocated, once, at construction. The caller
+ * passes the size back to deallocate(), so blocks carry no header. Not
+ * thread-safe.
+ */
+class buddy_allocator {
+  struct free_link {
+    free_link *next;
+    free_link *prev;
+  };
+
+  struct free_block {
+    free_link link;
+  };
+
+  using free_list = list<free_block, &free_block::link, true>;
+
+  static constexpr int kMaxOrders = 48;
+
+ public:
+  /**
+   * @param memory start of the arena, should be aligned to min_block
+   * @param bytes size of the arena, a tail smaller than min_block is unused
+   * @param min_block smallest block size, a power of two of at least
+   * 2 * sizeof(void *)
+   */
+  buddy_allocator(void *memory, size_t bytes, size_t min_block = 64)
+      : base_(static_cast<unsigned char *>(memory)) {
+    min_shift_ = min_block < sizeof(free_block)
+                     ? minimum_shift()
+                     : internal::find_first_set(min_block);
+    blocks_ = bytes >> min_shift_;
+
+    orders_ = 0;
+    while (orders_ < kMaxOrders && (blocks_ >> orders_) != 0) orders_++;
+
+    size_t bits = 0;
+    for (int order = 0; order < orders_; ++order) {
+      bitmap_base_[order] = bits;
+      bits += blocks_ >> order;
+    }
+    bitmap_.resize((bits + 63) / 64);
+
+    // Cover the arena with the largest aligned blocks that fit.
+    size_t offset = 0;
+    size_t end = blocks_ << min_shift_;
+    while (offset < end) {
+      int order = orders_ - 1;
+      while (order > 0 && ((offset & (block_size(order) - 1)) != 0 ||
+                           offset + block_size(order) > end)) {
+        order--;
+      }
+      push_free(offset, order);
+      offset += block_size(order);
+    }
+  }
+
+  buddy_allocator(const buddy_allocator &) = delete;
+  buddy_allocator &operator=(const buddy_allocator &) = delete;
+
+  /**
+   * allocate the smallest block that holds size bytes.
+   * @param size requested size
+   * @return block aligned to its size relative to the arena, or nullptr
+   */
+  void *allocate(size_t size) {
+    int order = order_of(size);
+    if (order >= orders_) return nullptr;
+
+    int found = order;
+    while (found < orders_ && free_[found].empty()) found++;
+    if (found == orders_) return nullptr;
+
+    size_t offset = pop_free(found);
+    // Hand the upper halves back until the block has the wanted order.
+    while (found > order) {
+      found--;
+      push_free(offset + block_size(found), found);
+    }
+    return base_ + offset;
+  }
+
+  /**
+   * return a block, merging it with its free buddies.
+   * @param ptr block obtained from allocate(), nullptr is ignored
+   * @param size size that was passed to allocate()
+   */
+  void deallocate(void *ptr, size_t size) {
+    if (!ptr) return;
+    int order = order_of(size);
+    size_t offset = static_cast<unsigned char *>(ptr) - base_;
+
+    while (order + 1 < orders_) {
+      size_t buddy = offset ^ block_size(order);
+      if (!is_free(buddy, order)) break;
+      clear_free(buddy, order);
+      free_[order].remove_if_exists(*block_at(buddy));
+      offset &= ~block_size(order);
+      order++;
+    }
+    push_free(offset, order);
+  }
+
+  /**
+   * return the block size allocate() hands out for size.
+   */
+  [[nodiscard]] size_t block_size_for(size_t size) const {
+    return block_size(order_of(size));
+  }
+
+  /**
+   * return the total size of all free blocks.
+   */
+  [[nodiscard]] size_t free_bytes() const {
+    size_t bytes = 0;
+    for (int order = 0; order < orders_; ++order) {
+      bytes += free_[order].size() * block_size(order);
+    }
+    return bytes;
+  }
+
+  /**
+   * return the size of the largest free block, 0 if there is none.
+   */
+  [[nodiscard]] size_t largest_free_block() const {
+    for (int order = orders_; order-- > 0;) {
+      if (!free_[order].empty()) return block_size(order);
+    }
+    return 0;
+  }
+
+  /**
+   * return the number of free blocks of the block size used for size.
+   */
+  [[nodiscard]] size_t free_blocks(size_t size) const {
+    int order = order_of(size);
+    return order < orders_ ? free_[order].size() : 0;
+  }
+
+  /**
+   * return the share of free memory that cannot be handed out as one block,
+   * 0 when all free memory is one block or nothing is free.
+   */
+  [[nodiscard]] double fragmentation() const {
+    size_t free = free_bytes();
+    if (free == 0) return 0;
+    return 1.0 - static_cast<double>(largest_free_block()) / free;
+  }
+
+ private:
+  static constexpr int minimum_shift() {
+    int shift = 0;
+    while ((size_t(1) << shift) < sizeof(free_block)) shift++;
+    return shift;
+  }
+
+  [[nodiscard]] size_t block_size(int order) const {
+    return size_t(1) << (min_shift_ + order);
+  }
+
+  [[nodiscard]] int order_of(size_t size) const {
+    int order = 0;
+    while (order < kMaxOrders && block_size(order) < size) order++;
+    return order;
+  }
+
+  free_block *block_at(size_t offset) {
+    return reinterpret_cast<free_block *>(base_ + offset);
+  }
+
+  [[nodiscard]] size_t bit_of(size_t offset, int order) const {
+    return bitmap_base_[order] + (offset >> (min_shift_ + order));
+  }
+
+  [[nodiscard]] bool is_free(size_t offset, int order) const {
+    // Buddies sticking out of the arena are never free.
+    if ((offset >> (min_shift_ + order)) >= (blocks_ >> order)) return false;
+    size_t bit = bit_of(offset, order);
+    return bitmap_[bit / 64] & (uint64_t(1) << (bit % 64));
+  }
+
+  void clear_free(size_t offset, int order) {
+    size_t bit = bit_of(offset, order);
+    bitmap_[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+  }
+
+  void push_free(size_t offset, int order) {
+    size_t bit = bit_of(offset, order);
+    bitmap_[bit / 64] |= uint64_t(1) << (bit % 64);
+    free_[order].push_front(*new (block_at(offset)) free_block{});
+  }
+
+  size_t pop_free(int order) {
+    free_block &block = free_[order].front();
+    free_[order].pop_front();
+    size_t offset = reinterpret_cast<unsigned char *>(&block) - base_;
+    clear_free(offset, order);
+    return offset;
+  }
+
+  unsigned char *base_;
+  int min_shift_;
+  int orders_;
+  size_t blocks_;
+  size_t bitmap_base_[kMaxOrders] = {};
+  std::vector<uint64_t> bitmap_;
+  free_list free_[kMaxOrders];
+};
+
+}  // namespace intrusive_list
@@ -21,4 +21,124 @@ static inline constexpr Type *owner_of(const Member *ptr,
                                   offset_of(member));
 }
 
+/**
+ * find_first_set - index of the least significant set bit
+ * @word: non-zero word
+ */
+static inline int find_first_set(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#else
+  int index = 0;
+  while (!(word & 1)) {
+    word >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/**
+ * size_counter - element counter selected by a container's size policy.
+ *
+ * The primary template tracks nothing and is empty, so containers that derive
+ * from it keep their original layout. The specialization keeps a running
+ * count so that size() becomes a single load.
+ */
+template <bool constant_time_size>
+struct size_counter {
+  static constexpr bool enabled = false;
+  void size_inc(size_t = 1) {}
+  void size_dec(size_t = 1) {}
+  void size_reset() {}
+  [[nodiscard]] size_t size_get() const { return 0; }
+};
+
+template <>
+struct size_counter<true> {
+  static constexpr bool enabled = true;
+  void size_inc(size_t n = 1) { count_ += n; }
+  void size_dec(size_t n = 1) { count_ -= n; }
+  void size_reset() { count_ = 0; }
+  [[nodiscard]] size_t size_get() const { return count_; }
+
+ private:
+  size_t count_ = 0;
+};
+
+/**
+ * chain_merge - merge two sorted nullptr-terminated chains
+ * @a: first chain, wins ties so that the merge is stable
+ * @b: second chain
+ * @less: strict weak ordering on nodes
+ *
+ * Only the next pointers are relinked, no memory is touched besides the
+ * nodes themselves.
+ */
+template <typename Node, typename Less>
+static inline Node *chain_merge(Node *a, Node *b, const Less &less) {
+  if (!a) return b;
+  if (!b) return a;
+
+  Node *head;
+  if (less(b, a)) {
+    head = b;
+    b = b->next;
+  } else {
+    head = a;
+    a = a->next;
+  }
+
+  Node *tail = head;
+  while (a && b) {
+    if (less(b, a)) {
+      tail->next = b;
+      tail = b;
+      b = b->next;
+    } else {
+      tail->next = a;
+      tail = a;
+      a = a->next;
+    }
+  }
+  tail->next = a ? a : b;
+  return head;
+}
+
+/**
+ * chain_sort - stable bottom-up merge sort of a nullptr-terminated chain
+ * @head: first node of the chain
+ * @less: strict weak ordering on nodes
+ *
+ * bins[i] holds a sorted run of 2^i nodes, so the extra memory is a fixed
+ * array of pointers regardless of the chain length.
+ */
+template <typename Node, typename Less>
+static inline Node *chain_sort(Node *head, const Less &less) {
+  constexpr int kMaxBins = sizeof(size_t) * 8;
+  Node *bins[kMaxBins] = {};
+  int used = 0;
+
+  while (head) {
+    Node *run = head;
+    head = head->next;
+    run->next = nullptr;
+
+    int i = 0;
+    for (; i < used && bins[i]; ++i) {
+      run = chain_merge(bins[i], run, less);
+      bins[i] = nullptr;
+    }
+    if (i == kMaxBins) i--;
+    if (i == used) used++;
+    bins[i] = run;
+  }
+
+  Node *result = nullptr;
+  for (int i = 0; i < used; ++i) {
+    result = chain_merge(bins[i], result, less);
+  }
+  return result;
+}
+
 }  // namespace intrusive_list::internal
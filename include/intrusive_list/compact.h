@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common.h"
+#include "list.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * relink_hook - move a double linked hook from one object to another
+ * @hook: hook in the new object, overwritten
+ * @next: next node of the old hook, nullptr if it was not linked
+ * @prev: previous node of the old hook
+ *
+ * Re-points the neighbours, list heads included, at the new hook.
+ */
+template <typename Node>
+static inline void relink_hook(Node *hook, void *next, void *prev) {
+  auto next_node = static_cast<Node *>(next);
+  auto prev_node = static_cast<Node *>(prev);
+  hook->next = next_node;
+  hook->prev = prev_node;
+  if (!next_node) return;
+  next_node->prev = hook;
+  prev_node->next = hook;
+}
+
+/*
+ * Read the links as raw pointers: copying a hook with relative links out of
+ * its object would re-encode them.
+ */
+template <typename Node>
+static inline void *hook_next(Node &hook) {
+  return static_cast<Node *>(hook.next);
+}
+
+template <typename Node>
+static inline void *hook_prev(Node &hook) {
+  return static_cast<Node *>(hook.prev);
+}
+
+/**
+ * relocate_with_hooks - relocate one object and carry its hooks over
+ * @old: object to relocate, linked through node_field and extra_hooks
+ * @relocate: callback returning the new location of @old
+ */
+template <auto node_field, auto... extra_hooks, typename T, typename Relocate>
+static inline T *relocate_with_hooks(T &old, Relocate &relocate) {
+  // relocate() may destroy the old object, read every hook first.
+  void *next = hook_next(old.*node_field);
+  void *prev = hook_prev(old.*node_field);
+  [[maybe_unused]] void *extra_next[] = {hook_next(old.*extra_hooks)...,
+                                         nullptr};
+  [[maybe_unused]] void *extra_prev[] = {hook_prev(old.*extra_hooks)...,
+                                         nullptr};
+
+  T *moved = relocate(old);
+  if (moved == &old) return moved;
+
+  relink_hook(&(moved->*node_field), next, prev);
+  [[maybe_unused]] size_t i = 0;
+  ((relink_hook(&(moved->*extra_hooks), extra_next[i], extra_prev[i]), ++i),
+   ...);
+  return moved;
+}
+
+}  // namespace internal
+
+/**
+ * compact - relocate the items of a list into traversal order
+ * @extra_hooks: member pointers to further list hooks of T whose links must
+ * survive the move, e.g. memberships in other lists
+ * @list: list to compact, keeps its order
+ * @relocate: T *relocate(T &old), moves old to its new place and returns
+ * it, typically move-constructing into the next free slot of an arena and
+ * destroying old; returning &old leaves the item where it is
+ *
+ * After long churn the items of a list end up scattered over the heap and
+ * every hop of a traversal misses the cache. Calling compact() with a
+ * relocate() that hands out consecutive slots lays the items out in list
+ * order, so later traversals walk memory sequentially.
+ *
+ * Items are relocated front to back. The hooks are read before relocate()
+ * runs and written into the new object afterwards, whatever its move
+ * constructor did with them, and the neighbours in every hooked list,
+ * list heads included, are re-pointed at the new object. Hooks must be
+ * double linked list hooks with next and prev; an extra hook whose next is
+ * nullptr is treated as unlinked. Pointers to items held anywhere else are
+ * the caller's business.
+ *
+ * @return number of items that moved
+ */
+template <auto... extra_hooks, typename T, auto node_field,
+          bool constant_time_size, typename Relocate>
+static inline size_t compact(list<T, node_field, constant_time_size> &list,
+                             Relocate &&relocate) {
+  size_t moved = 0;
+  for (auto it = list.begin(); it != list.end();) {
+    T &old = *it;
+    ++it;
+    if (internal::relocate_with_hooks<node_field, extra_hooks...>(
+            old, relocate) != &old) {
+      moved++;
+    }
+  }
+  return moved;
+}
+
+}  // namespace intrusive_list
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <type_traits>
+
 #include "common.h"
 
 namespace intrusive_list {
@@ -10,13 +13,38 @@ struct forward_list_node {
 
 /**
  * list double linked list.
+ *
+ * When constant_time_size is true the list keeps an element counter so that
+ * size() is O(1); otherwise size() walks the list.
+ *
+ * The hook is any struct with a next field that converts to and from a
+ * pointer to the hook, such as forward_list_node or
+ * relative_forward_list_node.
  */
-template <typename T, forward_list_node T::*node_field>
-class forward_list {
-  forward_list_node head_;
+template <typename T, decltype(auto) node_field,
+          bool constant_time_size = false>
+class forward_list : private internal::size_counter<constant_time_size> {
+  using Node = std::remove_reference_t<decltype((T *)nullptr->*node_field)>;
+  using Counter = internal::size_counter<constant_time_size>;
+
+  Node head_;
 
  public:
-  forward_list() : head_({nullptr}) {}
+  forward_list() { head_.next = nullptr; }
+
+  /**
+   * adopt a nullptr-terminated chain of hooks, e.g. one detached from a
+   * lock-free container.
+   * @param first first node of the chain, may be nullptr
+   */
+  explicit forward_list(Node *first) {
+    head_.next = first;
+    if constexpr (Counter::enabled) {
+      for (Node *node = first; node; node = node->next) {
+        Counter::size_inc();
+      }
+    }
+  }
 
   /**
    * insert item at the front of list.
@@ -25,6 +53,7 @@ class forward_list {
   void push_front(T &item) {
     get_node(&item)->next = head_.next;
     head_.next = get_node(&item);
+    Counter::size_inc();
   }
 
   bool is_singular() { return (head_.next && head_.next->next == nullptr); }
@@ -32,7 +61,10 @@ class forward_list {
   /**
    * remove the first item in the list.
    */
-  void pop_front() { head_.next = head_.next->next; }
+  void pop_front() {
+    head_.next = head_.next->next;
+    Counter::size_dec();
+  }
 
   /**
    * return first item in list.
@@ -58,18 +90,107 @@ class forward_list {
         node = &(*node)->next;
       }
     }
+    Counter::size_dec(removed);
     return removed;
   }
 
+  /**
+   * reverse the order of the items in place.
+   */
+  void reverse() {
+    Node *reversed = nullptr;
+    Node *node = head_.next;
+    while (node) {
+      Node *next = node->next;
+      node->next = reversed;
+      reversed = node;
+      node = next;
+    }
+    head_.next = reversed;
+  }
+
+  /**
+   * sort the list in place with a stable bottom-up merge sort.
+   * @param comp strict weak ordering on items
+   *
+   * Only the hooks are relinked, no memory is allocated.
+   */
+  template <typename Compare>
+  void sort(const Compare &comp) {
+    Node *first = head_.next;
+    head_.next = internal::chain_sort(first, node_compare(comp));
+  }
+
+  void sort() { sort(std::less<>()); }
+
+  /**
+   * merge a sorted list into this sorted list, leaving other empty.
+   * @param other list to merge, its items follow equal items of this list
+   * @param comp strict weak ordering on items
+   */
+  template <typename Compare>
+  void merge(forward_list &other, const Compare &comp) {
+    if (&other == this) return;
+    Node *mine = head_.next;
+    Node *theirs = other.head_.next;
+    head_.next = internal::chain_merge(mine, theirs, node_compare(comp));
+    other.head_.next = nullptr;
+    Counter::size_inc(other.Counter::size_get());
+    other.Counter::size_reset();
+  }
+
+  void merge(forward_list &other) { merge(other, std::less<>()); }
+
+  /**
+   * remove all but the first item of every run of consecutive equal items.
+   * @param pred equality predicate on items
+   * @return number of removed items
+   */
+  template <typename BinaryPredicate>
+  int unique(const BinaryPredicate &pred) {
+    int removed = 0;
+    Node *node = head_.next;
+    while (node && node->next) {
+      if (pred(*get_owner(node), *get_owner(node->next))) {
+        node->next = node->next->next;
+        removed++;
+      } else {
+        node = node->next;
+      }
+    }
+    Counter::size_dec(removed);
+    return removed;
+  }
+
+  int unique() { return unique(std::equal_to<>()); }
+
   /**
    * check if the list is empty.
    * @return true if list is empty.
    */
   bool empty() const { return head_.next == nullptr; }
 
+  /**
+   * return the number of items in the list.
+   * @return number of items in the list
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (const Node *node = head_.next; node; node = node->next) {
+        n++;
+      }
+      return n;
+    }
+  }
+
   struct Iterator {
-    explicit Iterator(forward_list_node *v) : node(v) {}
-    explicit operator forward_list_node *() const { return node; }
+    explicit Iterator(Node *v) : node(v) {}
+    explicit operator Node *() const { return node; }
     inline bool operator!=(const Iterator &rhs) const {
       return node != rhs.node;
     }
@@ -82,22 +203,54 @@ class forward_list {
       node = node->next;
       return *this;
     }
-    forward_list_node *node;
+    Node *node;
+  };
+
+  struct ConstIterator {
+    explicit ConstIterator(const Node *v) : node(v) {}
+    ConstIterator(const Iterator &it) : node(it.node) {}
+    explicit operator const Node *() const { return node; }
+    inline bool operator!=(const ConstIterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const ConstIterator &rhs) const {
+      return node == rhs.node;
+    }
+    const T &operator*() const { return *get_owner(node); }
+    const T *operator->() const { return get_owner(node); }
+    ConstIterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+    const Node *node;
   };
 
   Iterator begin() { return Iterator{head_.next}; }
-  Iterator begin() const { return Iterator{head_.next}; }
+  ConstIterator begin() const { return ConstIterator{head_.next}; }
   Iterator end() { return Iterator{nullptr}; }
-  Iterator end() const { return Iterator{nullptr}; }
+  ConstIterator end() const { return ConstIterator{nullptr}; }
+  ConstIterator cbegin() const { return begin(); }
+  ConstIterator cend() const { return end(); }
 
  private:
-  static inline constexpr forward_list_node *get_node(T *item) {
+  static inline constexpr Node *get_node(T *item) {
     return &(item->*node_field);
   }
 
-  static inline constexpr T *get_owner(forward_list_node *member) {
+  static inline constexpr T *get_owner(Node *member) {
     return internal::owner_of(member, node_field);
   }
+
+  static inline constexpr const T *get_owner(const Node *member) {
+    return internal::owner_of(member, node_field);
+  }
+
+  template <typename Compare>
+  static inline auto node_compare(const Compare &comp) {
+    return [&comp](Node *a, Node *b) {
+      return comp(*get_owner(a), *get_owner(b));
+    };
+  }
 };
 
 }  // namespace intrusive_list
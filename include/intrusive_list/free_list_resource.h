@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * null_mutex - lockable that does nothing, for single-threaded policies.
+ */
+struct null_mutex {
+  void lock() {}
+  void unlock() {}
+};
+
+}  // namespace internal
+
+/**
+ * free_list_resource std::pmr::memory_resource pooling small allocations in
+ * intrusive free lists.
+ *
+ * Requests up to max_chunk bytes are rounded up to a power of two size
+ * class. Every class keeps its free chunks in a forward_list threaded
+ * through the chunks themselves, so allocation and deallocation are a
+ * pop_front() and push_front(). An empty class is refilled by carving a
+ * block obtained from the upstream resource; blocks are linked into a
+ * forward_list of their own and returned by release() or the destructor.
+ * Larger or over-aligned requests go straight to upstream.
+ *
+ * With thread_safe every call takes a std::mutex, otherwise the resource
+ * must only be used by one thread at a time.
+ */
+template <bool thread_safe = false>
+class free_list_resource : public std::pmr::memory_resource {
+  struct chunk {
+    forward_list_node node;
+  };
+
+  struct block {
+    forward_list_node link;
+    size_t bytes;
+  };
+
+  using mutex_type =
+      std::conditional_t<thread_safe, std::mutex, internal::null_mutex>;
+
+  static constexpr size_t kAlign = alignof(std::max_align_t);
+  static constexpr size_t kHeaderSize =
+      (sizeof(block) + kAlign - 1) / kAlign * kAlign;
+  static constexpr int kMinShift = 4;
+  static constexpr int kClasses = 12;
+  // Smallest number of chunks carved from one block.
+  static constexpr size_t kMinChunksPerBlock = 8;
+
+  static_assert(sizeof(chunk) <= (size_t(1) << kMinShift));
+
+ public:
+  /**
+   * largest request served from the free lists.
+   */
+  static constexpr size_t max_chunk = size_t(1) << (kMinShift + kClasses - 1);
+
+  /**
+   * counters of a free_list_resource.
+   * @hits: allocations served from a free list without a refill
+   * @refills: blocks obtained from upstream for the free lists
+   * @bytes_held: bytes of those blocks, used or not
+   */
+  struct statistics {
+    size_t hits;
+    size_t refills;
+    size_t bytes_held;
+  };
+
+  /**
+   * @param upstream resource blocks and oversized requests come from
+   * @param block_bytes preferred size of the blocks carved into chunks
+   */
+  explicit free_list_resource(
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource(),
+      size_t block_bytes = 64 * 1024)
+      : upstream_(upstream), block_bytes_(block_bytes) {}
+
+  free_list_resource(const free_list_resource &) = delete;
+  free_list_resource &operator=(const free_list_resource &) = delete;
+
+  ~free_list_resource() override { release(); }
+
+  /**
+   * give all blocks back to upstream, invalidating every chunk handed out.
+   * Oversized allocations are not affected.
+   */
+  void release() {
+    std::lock_guard<mutex_type> lock(mutex_);
+    for (auto &free_list : free_) {
+      while (!free_list.empty()) free_list.pop_front();
+    }
+    while (!blocks_.empty()) {
+      block *b = &blocks_.front();
+      blocks_.pop_front();
+      upstream_->deallocate(b, b->bytes, kAlign);
+    }
+    stats_.bytes_held = 0;
+  }
+
+  [[nodiscard]] std::pmr::memory_resource *upstream_resource() const {
+    return upstream_;
+  }
+
+  /**
+   * return a snapshot of the counters.
+   */
+  [[nodiscard]] statistics stats() const {
+    std::lock_guard<mutex_type> lock(mutex_);
+    return stats_;
+  }
+
+ protected:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    int index = class_of(bytes, alignment);
+    if (index < 0) return upstream_->allocate(bytes, alignment);
+
+    std::lock_guard<mutex_type> lock(mutex_);
+    auto &free_list = free_[index];
+    if (free_list.empty()) {
+      refill(index);
+    } else {
+      stats_.hits++;
+    }
+    chunk &c = free_list.front();
+    free_list.pop_front();
+    return &c;
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    int index = class_of(bytes, alignment);
+    if (index < 0) return upstream_->deallocate(p, bytes, alignment);
+
+    std::lock_guard<mutex_type> lock(mutex_);
+    free_[index].push_front(*new (p) chunk{});
+  }
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  /**
+   * return the size class of a request, -1 for requests left to upstream.
+   */
+  static int class_of(size_t bytes, size_t alignment) {
+    if (alignment > kAlign) return -1;
+    if (bytes < alignment) bytes = alignment;
+    if (bytes > max_chunk) return -1;
+    int index = 0;
+    while ((size_t(1) << (kMinShift + index)) < bytes) index++;
+    return index;
+  }
+
+  void refill(int index) {
+    size_t chunk_size = size_t(1) << (kMinShift + index);
+    size_t bytes = block_bytes_;
+    if (bytes < kHeaderSize + kMinChunksPerBlock * chunk_size) {
+      bytes = kHeaderSize + kMinChunksPerBlock * chunk_size;
+    }
+
+    void *memory = upstream_->allocate(bytes, kAlign);
+    auto b = new (memory) block{};
+    b->bytes = bytes;
+    blocks_.push_front(*b);
+    stats_.refills++;
+    stats_.bytes_held += bytes;
+
+    // Push in reverse so that allocations walk the block in address order.
+    auto chunks = static_cast<unsigned char *>(memory) + kHeaderSize;
+    for (size_t i = (bytes - kHeaderSize) / chunk_size; i-- > 0;) {
+      free_[index].push_front(*new (chunks + i * chunk_size) chunk{});
+    }
+  }
+
+  std::pmr::memory_resource *upstream_;
+  size_t block_bytes_;
+  mutable mutex_type mutex_;
+  forward_list<chunk, &chunk::node> free_[kClasses];
+  forward_list<block, &block::link> blocks_;
+  statistics stats_ = {};
+};
+
+}  // namespace intrusive_list
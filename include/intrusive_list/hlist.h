@@ -0,0 +1,195 @@
+#pragma once
+
+#include "common.h"
+
+namespace intrusive_list {
+
+/**
+ * hlist_node hook of hlist.
+ * @next: next node, nullptr at the end of the list
+ * @pprev: address of the next field pointing at this node (either the list
+ * head or the previous node), nullptr when the node is not linked
+ */
+struct hlist_node {
+  struct hlist_node *next;
+  struct hlist_node **pprev;
+};
+
+/**
+ * hlist double linked list with a single pointer head, after the Linux
+ * kernel hlist.
+ *
+ * The head is one pointer, half of a list head, which matters for large
+ * bucket arrays of hash tables and timer wheels. Nodes point back at the
+ * pointer that points at them instead of at the previous node, so a node
+ * can still unlink itself in O(1) without knowing its list. There is no
+ * O(1) access to the last item.
+ */
+template <typename T, hlist_node T::*node_field>
+class hlist {
+  hlist_node *first_;
+
+ public:
+  hlist() noexcept : first_(nullptr) {}
+
+  hlist(const hlist &) = delete;
+  hlist &operator=(const hlist &) = delete;
+
+  /**
+   * take over the items of other in O(1), leaving other empty.
+   */
+  hlist(hlist &&other) noexcept : first_(other.first_) {
+    other.first_ = nullptr;
+    if (first_) first_->pprev = &first_;
+  }
+
+  /**
+   * unlink the current items, then take over the items of other in O(1).
+   */
+  hlist &operator=(hlist &&other) noexcept {
+    if (&other != this) {
+      clear();
+      first_ = other.first_;
+      other.first_ = nullptr;
+      if (first_) first_->pprev = &first_;
+    }
+    return *this;
+  }
+
+  /**
+   * insert item at the front of list.
+   * @param item item to insert in list.
+   */
+  void push_front(T &item) {
+    auto node = get_node(&item);
+    node->next = first_;
+    if (first_) first_->pprev = &node->next;
+    first_ = node;
+    node->pprev = &first_;
+  }
+
+  /**
+   * insert item after pos.
+   * @param pos item already in this list
+   * @param item item to insert
+   */
+  static void insert_after(T &pos, T &item) {
+    auto prev = get_node(&pos);
+    auto node = get_node(&item);
+    node->next = prev->next;
+    if (node->next) node->next->pprev = &node->next;
+    prev->next = node;
+    node->pprev = &prev->next;
+  }
+
+  /**
+   * insert item before pos.
+   * @param pos item already in this list
+   * @param item item to insert
+   */
+  static void insert_before(T &pos, T &item) {
+    auto next = get_node(&pos);
+    auto node = get_node(&item);
+    node->pprev = next->pprev;
+    node->next = next;
+    next->pprev = &node->next;
+    *node->pprev = node;
+  }
+
+  /**
+   * unlink item from whatever hlist it is in, no head needed.
+   * @param item item to remove
+   * @return true When the deletion is successful
+   * @return false When the item was not linked
+   */
+  static bool remove_if_exists(T &item) {
+    auto node = get_node(&item);
+    if (!node->pprev) return false;
+    *node->pprev = node->next;
+    if (node->next) node->next->pprev = node->pprev;
+    node->next = nullptr;
+    node->pprev = nullptr;
+    return true;
+  }
+
+  /**
+   * check if item is linked into an hlist.
+   */
+  static bool is_linked(const T &item) {
+    return get_node(const_cast<T *>(&item))->pprev != nullptr;
+  }
+
+  /**
+   * unlink all items, their hooks are reset so remove_if_exists() on them
+   * returns false.
+   */
+  void clear() {
+    while (first_) {
+      auto node = first_;
+      first_ = node->next;
+      node->next = nullptr;
+      node->pprev = nullptr;
+    }
+  }
+
+  /**
+   * remove the first item in the list.
+   */
+  void pop_front() { remove_if_exists(front()); }
+
+  /**
+   * return first item in list.
+   * @return first item in list
+   *
+   * Note list need not empty.
+   */
+  T &front() { return *get_owner(first_); }
+
+  bool is_singular() { return first_ && first_->next == nullptr; }
+
+  /**
+   * check if the list is empty.
+   * @return true if list is empty.
+   */
+  [[nodiscard]] bool empty() const { return first_ == nullptr; }
+
+  struct Iterator {
+    explicit Iterator(hlist_node *v) : node(v) {}
+    explicit operator hlist_node *() const { return node; }
+    inline bool operator!=(const Iterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const Iterator &rhs) const {
+      return node == rhs.node;
+    }
+    T &operator*() const { return *get_owner(node); }
+    T *operator->() const { return get_owner(node); }
+    Iterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+    hlist_node *node;
+  };
+
+  Iterator begin() { return Iterator{first_}; }
+  Iterator begin() const { return Iterator{first_}; }
+  Iterator end() { return Iterator{nullptr}; }
+  Iterator end() const { return Iterator{nullptr}; }
+
+  Iterator erase(Iterator position) {
+    Iterator ret = Iterator(position.node->next);
+    remove_if_exists(*get_owner(position.node));
+    return ret;
+  }
+
+ private:
+  static inline constexpr hlist_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(hlist_node *member) {
+    return internal::owner_of(member, node_field);
+  }
+};
+
+}  // namespace intrusive_list
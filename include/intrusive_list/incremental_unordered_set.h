@@ -0,0 +1,197 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "common.h"
+#include "forward_list.h"
+#include "unordered_set.h"
+
+namespace intrusive_list {
+
+/**
+ * incremental_unordered_set intrusive chained hash table with incremental
+ * rehashing.
+ *
+ * Same interface and hooks as unordered_set, but growing never relinks the
+ * whole table at once. When the load factor exceeds 1 a bucket array of
+ * twice the size is allocated next to the old one, and every insert() and
+ * erase() then migrates at most migrate_buckets old buckets into it. Since
+ * old bucket i splits into new buckets 2i and 2i + 1, a key whose old bucket
+ * is below the migration cursor lives in the new array and every other key
+ * in the old one, so a lookup still probes a single chain.
+ *
+ * The next doubling is at least as many inserts away as there are old
+ * buckets, so a migration normally finishes long before it; the cost of a
+ * rehash is spread evenly over those inserts.
+ */
+template <typename T, forward_list_node T::*node_field, typename KeyOf,
+          typename Hash = std::hash<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>,
+          typename KeyEqual = std::equal_to<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>,
+          size_t migrate_buckets = 8>
+class incremental_unordered_set
+    : private internal::hash_chains<T, node_field, KeyOf, Hash, KeyEqual> {
+  static_assert(migrate_buckets > 0);
+
+  using Chains = internal::hash_chains<T, node_field, KeyOf, Hash, KeyEqual>;
+  friend struct internal::hash_iterator<T, node_field,
+                                        incremental_unordered_set>;
+
+ public:
+  using typename Chains::key_type;
+  using Chains::empty;
+  using Chains::size;
+
+  explicit incremental_unordered_set(size_t bucket_count = 16,
+                                     Hash hash = Hash(),
+                                     KeyEqual equal = KeyEqual(),
+                                     KeyOf key_of = KeyOf())
+      : Chains(hash, equal, key_of) {
+    bits_ = internal::hash_bucket_bits(bucket_count ? bucket_count : 1);
+    buckets_ = Chains::allocate_buckets(bits_);
+  }
+
+  incremental_unordered_set(const incremental_unordered_set &) = delete;
+  incremental_unordered_set &operator=(const incremental_unordered_set &) =
+      delete;
+
+  /**
+   * insert item, advancing or starting a rehash if needed.
+   * @param item item to insert, its hook must not be linked
+   * @return false if an item with the same key is already present, in which
+   * case nothing changes.
+   */
+  bool insert(T &item) {
+    rehash_step(migrate_buckets);
+
+    const key_type &key = Chains::key_of(item);
+    size_t hash = Chains::hash_key(key);
+    if (Chains::find_in_bucket(locate(hash), key)) return false;
+
+    if (size() >= bucket_count()) {
+      // Every insert migrates at least one old bucket, so the previous
+      // migration has normally finished; make sure before doubling again.
+      rehash_step(old_bucket_count());
+      start_grow();
+    }
+
+    Chains::link(locate(hash), item);
+    return true;
+  }
+
+  /**
+   * look up an item by key.
+   * @param key key of the item
+   * @return the item, or nullptr if it is not present
+   */
+  T *find(const key_type &key) const {
+    auto node = Chains::find_in_bucket(locate(Chains::hash_key(key)), key);
+    return node ? Chains::get_owner(node) : nullptr;
+  }
+
+  bool contains(const key_type &key) const { return find(key) != nullptr; }
+
+  /**
+   * remove an item by key.
+   * @param key key of the item
+   * @return the removed item, or nullptr if it is not present
+   */
+  T *erase(const key_type &key) {
+    rehash_step(migrate_buckets);
+    return Chains::unlink_key(locate(Chains::hash_key(key)), key);
+  }
+
+  /**
+   * remove a specific item.
+   * @param item item to remove
+   * @return false if item is not in this set
+   */
+  bool erase(T &item) {
+    rehash_step(migrate_buckets);
+    size_t hash = Chains::hash_key(Chains::key_of(item));
+    return Chains::unlink_item(locate(hash), item);
+  }
+
+  /**
+   * migrate up to count old buckets, e.g. from an idle loop.
+   * @param count maximum number of old buckets to migrate
+   * @return true while a rehash is still in progress
+   */
+  bool rehash_step(size_t count) {
+    if (!old_buckets_) return false;
+
+    size_t old_count = old_bucket_count();
+    for (; count && migrate_pos_ < old_count; --count, ++migrate_pos_) {
+      Chains::move_chain(&old_buckets_[migrate_pos_], buckets_.get(), bits_);
+    }
+
+    if (migrate_pos_ == old_count) old_buckets_.reset();
+    return old_buckets_ != nullptr;
+  }
+
+  /**
+   * drop all items, their hooks are left untouched.
+   */
+  void clear() {
+    old_buckets_.reset();
+    Chains::clear_buckets(buckets_.get(), bucket_count());
+  }
+
+  [[nodiscard]] bool rehashing() const { return old_buckets_ != nullptr; }
+  [[nodiscard]] size_t bucket_count() const { return size_t(1) << bits_; }
+  [[nodiscard]] float load_factor() const {
+    return static_cast<float>(size()) / static_cast<float>(bucket_count());
+  }
+
+  /**
+   * Visits the new bucket array, then the old buckets that have not been
+   * migrated yet. Must not be held across insert() or erase(), which move
+   * items between the arrays.
+   */
+  using Iterator =
+      internal::hash_iterator<T, node_field, incremental_unordered_set>;
+
+  Iterator begin() const { return Iterator{this, 0, buckets_[0].next}; }
+  Iterator end() const { return Iterator{this, iteration_end(), nullptr}; }
+
+ private:
+  void start_grow() {
+    old_buckets_ = std::move(buckets_);
+    bits_++;
+    buckets_ = Chains::allocate_buckets(bits_);
+    migrate_pos_ = 0;
+  }
+
+  size_t old_bucket_count() const {
+    return old_buckets_ ? bucket_count() / 2 : 0;
+  }
+
+  forward_list_node *locate(size_t hash) const {
+    if (old_buckets_) {
+      size_t old_index = internal::hash_bucket_index(hash, bits_ - 1);
+      if (old_index >= migrate_pos_) return &old_buckets_[old_index];
+    }
+    return &buckets_[internal::hash_bucket_index(hash, bits_)];
+  }
+
+  size_t iteration_end() const {
+    return old_buckets_ ? bucket_count() + old_bucket_count() - migrate_pos_
+                        : bucket_count();
+  }
+
+  // Indexes the new array first, then continues into the old one.
+  forward_list_node *iteration_bucket(size_t i) const {
+    if (i < bucket_count()) return &buckets_[i];
+    return &old_buckets_[migrate_pos_ + i - bucket_count()];
+  }
+
+  std::unique_ptr<forward_list_node[]> buckets_;
+  std::unique_ptr<forward_list_node[]> old_buckets_;
+  int bits_ = 0;
+  size_t migrate_pos_ = 0;
+};
+
+}  // namespace intrusive_list
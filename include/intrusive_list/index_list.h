@@ -0,0 +1,328 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "common.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * index_nil - link value marking the end of an index linked list
+ */
+template <typename Index>
+inline constexpr Index index_nil = std::numeric_limits<Index>::max();
+
+/**
+ * index_unlinked - link value of a hook that is not in any list
+ */
+template <typename Index>
+inline constexpr Index index_unlinked = std::numeric_limits<Index>::max() - 1;
+
+/*
+ * The helpers below work on any link storage: links.next(i) and
+ * links.prev(i) return references to the links of slot i, and head and tail
+ * are index_nil when the list is empty.
+ */
+
+/**
+ * index_list_splice - link the detached slots [first, last] before slot pos
+ * @links: link storage
+ * @head: first slot of the list
+ * @tail: last slot of the list
+ * @first: first slot of the detached range
+ * @last: last slot of the detached range, may be equal to @first
+ * @pos: slot that will follow @last, index_nil to append
+ */
+template <typename Links, typename Index>
+static inline void index_list_splice(Links &links, Index &head, Index &tail,
+                                     Index first, Index last, Index pos) {
+  Index prev = pos == index_nil<Index> ? tail : links.prev(pos);
+  links.next(last) = pos;
+  links.prev(first) = prev;
+  if (prev == index_nil<Index>) {
+    head = first;
+  } else {
+    links.next(prev) = first;
+  }
+  if (pos == index_nil<Index>) {
+    tail = last;
+  } else {
+    links.prev(pos) = last;
+  }
+}
+
+/**
+ * index_list_insert - link slot i before slot pos
+ */
+template <typename Links, typename Index>
+static inline void index_list_insert(Links &links, Index &head, Index &tail,
+                                     Index i, Index pos) {
+  index_list_splice(links, head, tail, i, i, pos);
+}
+
+/**
+ * index_list_cut - detach the slots [first, last] from their list
+ * @links: link storage
+ * @head: first slot of the list
+ * @tail: last slot of the list
+ * @first: first slot to detach
+ * @last: last slot to detach, may be equal to @first
+ *
+ * The detached slots keep their links among themselves.
+ */
+template <typename Links, typename Index>
+static inline void index_list_cut(Links &links, Index &head, Index &tail,
+                                  Index first, Index last) {
+  Index prev = links.prev(first);
+  Index next = links.next(last);
+  if (prev == index_nil<Index>) {
+    head = next;
+  } else {
+    links.next(prev) = next;
+  }
+  if (next == index_nil<Index>) {
+    tail = prev;
+  } else {
+    links.prev(next) = prev;
+  }
+}
+
+/**
+ * index_list_remove - unlink slot i and mark it unlinked
+ */
+template <typename Links, typename Index>
+static inline void index_list_remove(Links &links, Index &head, Index &tail,
+                                     Index i) {
+  index_list_cut(links, head, tail, i, i);
+  links.next(i) = index_unlinked<Index>;
+  links.prev(i) = index_unlinked<Index>;
+}
+
+}  // namespace internal
+
+/**
+ * index_list_node hook of index_list.
+ * @next: slot of the next item, index_nil at the end of the list
+ * @prev: slot of the previous item, index_nil at the front of the list
+ *
+ * A default constructed hook is unlinked.
+ */
+template <typename Index = uint32_t>
+struct index_list_node {
+  static_assert(std::is_unsigned_v<Index>, "Index must be unsigned");
+
+  Index next = internal::index_unlinked<Index>;
+  Index prev = internal::index_unlinked<Index>;
+};
+
+/**
+ * index_list double linked list of items stored in one array.
+ *
+ * Hooks hold 16 or 32 bit slot indices into the array instead of pointers,
+ * so a hook is 4 or 8 bytes and the list head is two indices. The two
+ * largest index values are reserved, an array may hold up to 2^16 - 2 or
+ * 2^32 - 2 items. Growing a std::vector moves the array, call rebase()
+ * afterwards; the links themselves stay valid.
+ *
+ * When constant_time_size is true the list keeps an element counter so that
+ * size() is O(1); otherwise size() walks the list.
+ */
+template <typename T, decltype(auto) node_field,
+          bool constant_time_size = false>
+class index_list : private internal::size_counter<constant_time_size> {
+  using Node = std::remove_reference_t<decltype((T *)nullptr->*node_field)>;
+  using Index = std::remove_cv_t<decltype(Node::next)>;
+  using Counter = internal::size_counter<constant_time_size>;
+
+  static constexpr Index kNil = internal::index_nil<Index>;
+  static constexpr Index kUnlinked = internal::index_unlinked<Index>;
+
+  // Link accessors for the internal helpers.
+  struct links {
+    T *base;
+    Index &next(Index i) const { return (base[i].*node_field).next; }
+    Index &prev(Index i) const { return (base[i].*node_field).prev; }
+  };
+
+  links links_;
+  Index head_ = kNil;
+  Index tail_ = kNil;
+
+ public:
+  /**
+   * @param base first element of the array holding the items
+   */
+  explicit index_list(T *base) noexcept : links_{base} {}
+
+  index_list(const index_list &) = delete;
+  index_list &operator=(const index_list &) = delete;
+
+  /**
+   * point the list at the new location of its array, e.g. after a
+   * std::vector grew.
+   */
+  void rebase(T *base) noexcept { links_.base = base; }
+
+  /**
+   * insert item at the front of list.
+   * @param item item of the array to insert
+   */
+  void push_front(T &item) {
+    internal::index_list_insert(links_, head_, tail_, index_of(item), head_);
+    Counter::size_inc();
+  }
+
+  /**
+   * insert item at the back of list.
+   * @param item item of the array to insert
+   */
+  void push_back(T &item) {
+    internal::index_list_insert(links_, head_, tail_, index_of(item), kNil);
+    Counter::size_inc();
+  }
+
+  /**
+   * @param item item to remove
+   * @return true When the deletion is successful
+   * @return false When the item was not linked
+   */
+  bool remove_if_exists(T &item) {
+    if (!is_linked(item)) return false;
+    internal::index_list_remove(links_, head_, tail_, index_of(item));
+    Counter::size_dec();
+    return true;
+  }
+
+  /**
+   * check if item is linked into a list.
+   */
+  static bool is_linked(const T &item) {
+    return (item.*node_field).next != kUnlinked;
+  }
+
+  /**
+   * unlink all items, their hooks are reset so remove_if_exists() on them
+   * returns false.
+   */
+  void clear() {
+    Index i = head_;
+    while (i != kNil) {
+      Index next = links_.next(i);
+      links_.next(i) = kUnlinked;
+      links_.prev(i) = kUnlinked;
+      i = next;
+    }
+    head_ = tail_ = kNil;
+    Counter::size_reset();
+  }
+
+  /**
+   * remove the first item in the list.
+   */
+  void pop_front() {
+    internal::index_list_remove(links_, head_, tail_, head_);
+    Counter::size_dec();
+  }
+
+  /**
+   * remove the last item in the list.
+   */
+  void pop_back() {
+    internal::index_list_remove(links_, head_, tail_, tail_);
+    Counter::size_dec();
+  }
+
+  /**
+   * return first item in list.
+   * @return first item in list
+   *
+   * Note list need not empty.
+   */
+  T &front() { return links_.base[head_]; }
+
+  /**
+   * return last item in list.
+   * @return last item in list
+   *
+   * Note list need not empty.
+   */
+  T &back() { return links_.base[tail_]; }
+
+  bool is_singular() { return head_ != kNil && head_ == tail_; }
+
+  /**
+   * check if the list is empty.
+   * @return true if list is empty.
+   */
+  [[nodiscard]] bool empty() const { return head_ == kNil; }
+
+  /**
+   * return the number of items in the list.
+   * @return number of items in the list
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (Index i = head_; i != kNil; i = links_.next(i)) n++;
+      return n;
+    }
+  }
+
+  struct Iterator {
+    Iterator(T *b, Index i) : base(b), index(i) {}
+    inline bool operator!=(const Iterator &rhs) const {
+      return index != rhs.index;
+    }
+    inline bool operator==(const Iterator &rhs) const {
+      return index == rhs.index;
+    }
+    T &operator*() const { return base[index]; }
+    T *operator->() const { return &base[index]; }
+    Iterator &operator++() {
+      index = (base[index].*node_field).next;
+      return *this;
+    }
+    T *base;
+    Index index;
+  };
+
+  Iterator begin() { return Iterator{links_.base, head_}; }
+  Iterator begin() const { return Iterator{links_.base, head_}; }
+  Iterator end() { return Iterator{links_.base, kNil}; }
+  Iterator end() const { return Iterator{links_.base, kNil}; }
+
+  Iterator erase(Iterator position) {
+    Iterator ret = Iterator(links_.base, links_.next(position.index));
+    internal::index_list_remove(links_, head_, tail_, position.index);
+    Counter::size_dec();
+    return ret;
+  }
+
+  /**
+   * insert item before position.
+   * @param position item that will follow item, end() to append
+   * @param item item of the array to insert
+   * @return iterator to item
+   */
+  Iterator insert(Iterator position, T &item) {
+    Index i = index_of(item);
+    internal::index_list_insert(links_, head_, tail_, i, position.index);
+    Counter::size_inc();
+    return Iterator(links_.base, i);
+  }
+
+ private:
+  Index index_of(const T &item) const {
+    return static_cast<Index>(&item - links_.base);
+  }
+};
+
+}  // namespace intrusive_list
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <functional>
 #include <type_traits>
+#include <utility>
 
 #include "common.h"
 
@@ -31,7 +33,7 @@ static inline void _list_add(Node *new_, Node *prev, Node *next) {
  */
 template <typename Node>
 static inline void list_add(Node *new_, Node *head) {
-  _list_add(new_, head, head->next);
+  _list_add<Node>(new_, head, head->next);
 }
 
 /**
@@ -44,7 +46,7 @@ static inline void list_add(Node *new_, Node *head) {
  */
 template <typename Node>
 static inline void list_add_tail(Node *new_, Node *head) {
-  _list_add(new_, head->prev, head);
+  _list_add<Node>(new_, head->prev, head);
 }
 
 /**
@@ -101,34 +103,129 @@ static inline int list_is_singular(const Node *head) {
   return !list_empty(head) && (head->next == head->prev);
 }
 
+/**
+ * list_init_head - make a list front point to itself
+ * @head: the front of the list
+ */
+template <typename Node>
+static inline void list_init_head(Node *head) {
+  head->next = head;
+  head->prev = head;
+}
+
+/**
+ * list_cut_range - detach the entries [first, last] from their list
+ * @first: first entry to detach
+ * @last: last entry to detach, may be equal to @first
+ *
+ * The detached entries keep their links among themselves.
+ */
+template <typename Node>
+static inline void list_cut_range(Node *first, Node *last) {
+  first->prev->next = last->next;
+  last->next->prev = first->prev;
+}
+
+/**
+ * list_splice_range - insert detached entries [first, last] before next
+ * @first: first entry of the detached range
+ * @last: last entry of the detached range
+ * @next: the entry that will follow @last
+ */
+template <typename Node>
+static inline void list_splice_range(Node *first, Node *last, Node *next) {
+  Node *prev = next->prev;
+  first->prev = prev;
+  prev->next = first;
+  last->next = next;
+  next->prev = last;
+}
+
+/**
+ * list_relink_chain - rebuild a ring from a nullptr-terminated chain
+ * @head: the front of the list
+ * @first: first entry of the chain, linked through next only
+ *
+ * Used after algorithms that only maintain next pointers, restores the prev
+ * pointers and closes the ring through @head.
+ */
+template <typename Node>
+static inline void list_relink_chain(Node *head, Node *first) {
+  Node *prev = head;
+  for (Node *node = first; node; node = node->next) {
+    prev->next = node;
+    node->prev = prev;
+    prev = node;
+  }
+  prev->next = head;
+  head->prev = prev;
+}
+
 }  // namespace internal
 
 /**
  * list double linked list.
+ *
+ * When constant_time_size is true the list keeps an element counter so that
+ * size() is O(1); otherwise size() walks the list and the layout stays a
+ * bare two-pointer head.
+ *
+ * The hook is any struct with next and prev fields that convert to and from
+ * a pointer to the hook, raw pointers or e.g. relative_list_node.
  */
-template <typename T, decltype(auto) node_field>
-class list {
+template <typename T, decltype(auto) node_field,
+          bool constant_time_size = false>
+class list : private internal::size_counter<constant_time_size> {
   using Node = std::remove_reference_t<decltype((T *)nullptr->*node_field)>;
+  using Counter = internal::size_counter<constant_time_size>;
 
   Node head_;
 
  public:
-  list() noexcept : head_({&head_, &head_}) {}
+  list() noexcept { internal::list_init_head(&head_); }
+
+  list(const list &) = delete;
+  list &operator=(const list &) = delete;
+
+  /**
+   * take over the items of other in O(1), leaving other empty.
+   */
+  list(list &&other) noexcept : list() { swap(other); }
+
+  /**
+   * unlink the current items, then take over the items of other in O(1).
+   */
+  list &operator=(list &&other) noexcept {
+    if (&other != this) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
 
   /**
    * insert item at the front of list.
    * @param item item to insert in list.
    */
-  void push_front(T &item) { internal::list_add(get_node(&item), &head_); }
+  void push_front(T &item) {
+    internal::list_add(get_node(&item), &head_);
+    Counter::size_inc();
+  }
 
   /**
    * insert item at the back of list.
    * @param item item to insert in list.
    */
-  void push_back(T &item) { internal::list_add_tail(get_node(&item), &head_); }
+  void push_back(T &item) {
+    internal::list_add_tail(get_node(&item), &head_);
+    Counter::size_inc();
+  }
 
   /**
-   * Note that the node must already be in a list
+   * Note that the item must be unlinked or linked into this list: the hook
+   * does not tell which list it is in, an item of another list would be
+   * unlinked from there and, with constant_time_size, throw off the size()
+   * of both lists.
    * @param item item to remove
    * @return true When the deletion is successful
    * @return false When the deletion fails
@@ -137,23 +234,46 @@ class list {
     decltype(auto) node = get_node(&item);
     if (node->next && node->prev) {
       internal::list_remove_self_from_list(node);
+      Counter::size_dec();
       return true;
     }
     return false;
   }
 
+  /**
+   * unlink all items, their hooks are reset so remove_if_exists() on them
+   * returns false.
+   */
+  void clear() {
+    Node *node = head_.next;
+    while (node != &head_) {
+      Node *next = node->next;
+      node->next = nullptr;
+      node->prev = nullptr;
+      node = next;
+    }
+    internal::list_init_head(&head_);
+    Counter::size_reset();
+  }
+
   void rotate_left() { internal::list_rotate_left(&head_); }
   bool is_singular() { return internal::list_is_singular(&head_); }
 
   /**
    * remove the first item in the list.
    */
-  void pop_front() { internal::list_remove_self_from_list(get_node(&front())); }
+  void pop_front() {
+    internal::list_remove_self_from_list(get_node(&front()));
+    Counter::size_dec();
+  }
 
   /**
    * remove the last item in the list.
    */
-  void pop_back() { internal::list_remove_self_from_list(get_node(&back())); }
+  void pop_back() {
+    internal::list_remove_self_from_list(get_node(&back()));
+    Counter::size_dec();
+  }
 
   /**
    * return first item in list.
@@ -177,6 +297,86 @@ class list {
    */
   [[nodiscard]] bool empty() const { return internal::list_empty(&head_); }
 
+  /**
+   * return the number of items in the list.
+   * @return number of items in the list
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (const Node *node = head_.next; node != &head_; node = node->next) {
+        n++;
+      }
+      return n;
+    }
+  }
+
+  /**
+   * sort the list in place with a stable bottom-up merge sort.
+   * @param comp strict weak ordering on items
+   *
+   * Only the hooks are relinked, no memory is allocated.
+   */
+  template <typename Compare>
+  void sort(const Compare &comp) {
+    if (head_.next == head_.prev) return;
+    head_.prev->next = nullptr;
+    Node *first = head_.next;
+    first = internal::chain_sort(first, node_compare(comp));
+    internal::list_relink_chain(&head_, first);
+  }
+
+  void sort() { sort(std::less<>()); }
+
+  /**
+   * merge a sorted list into this sorted list, leaving other empty.
+   * @param other list to merge, its items follow equal items of this list
+   * @param comp strict weak ordering on items
+   */
+  template <typename Compare>
+  void merge(list &other, const Compare &comp) {
+    if (&other == this || other.empty()) return;
+    Node *mine = empty() ? nullptr : static_cast<Node *>(head_.next);
+    Node *theirs = other.head_.next;
+    head_.prev->next = nullptr;
+    other.head_.prev->next = nullptr;
+    Node *first = internal::chain_merge(mine, theirs, node_compare(comp));
+    internal::list_relink_chain(&head_, first);
+    internal::list_init_head(&other.head_);
+    Counter::size_inc(other.Counter::size_get());
+    other.Counter::size_reset();
+  }
+
+  void merge(list &other) { merge(other, std::less<>()); }
+
+  /**
+   * remove all but the first item of every run of consecutive equal items.
+   * @param pred equality predicate on items
+   * @return number of removed items
+   */
+  template <typename BinaryPredicate>
+  int unique(const BinaryPredicate &pred) {
+    int removed = 0;
+    if (empty()) return removed;
+    Node *node = head_.next;
+    while (node->next != &head_) {
+      if (pred(*get_owner(node), *get_owner(node->next))) {
+        internal::list_remove_self_from_list(node->next);
+        removed++;
+      } else {
+        node = node->next;
+      }
+    }
+    Counter::size_dec(removed);
+    return removed;
+  }
+
+  int unique() { return unique(std::equal_to<>()); }
+
   struct Iterator {
     explicit Iterator(Node *v) : node(v) {}
     explicit operator Node *() const { return node; }
@@ -195,17 +395,114 @@ class list {
     Node *node;
   };
 
+  struct ConstIterator {
+    explicit ConstIterator(const Node *v) : node(v) {}
+    ConstIterator(const Iterator &it) : node(it.node) {}
+    explicit operator const Node *() const { return node; }
+    inline bool operator!=(const ConstIterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const ConstIterator &rhs) const {
+      return node == rhs.node;
+    }
+    const T &operator*() const { return *get_owner(node); }
+    const T *operator->() const { return get_owner(node); }
+    ConstIterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+    const Node *node;
+  };
+
   Iterator begin() { return Iterator{head_.next}; }
-  Iterator begin() const { return Iterator{head_.next}; }
+  ConstIterator begin() const { return ConstIterator{head_.next}; }
   Iterator end() { return Iterator{&head_}; }
-  Iterator end() const { return Iterator{&head_}; }
+  ConstIterator end() const { return ConstIterator{&head_}; }
+  ConstIterator cbegin() const { return begin(); }
+  ConstIterator cend() const { return end(); }
 
   Iterator erase(Iterator position) {
     Iterator ret = Iterator((position.node->next));
     internal::list_remove_self_from_list(position.node);
+    Counter::size_dec();
     return ret;
   }
 
+  /**
+   * move all items of other before position, leaving other empty.
+   * @param position item that will follow the moved items
+   * @param other list to take items from
+   *
+   * Only the boundary nodes are patched, this is O(1).
+   */
+  void splice(Iterator position, list &other) {
+    if (&other == this || other.empty()) return;
+    Node *first = other.head_.next;
+    Node *last = other.head_.prev;
+    internal::list_init_head(&other.head_);
+    internal::list_splice_range(first, last, position.node);
+    Counter::size_inc(other.Counter::size_get());
+    other.Counter::size_reset();
+  }
+
+  /**
+   * move the items [first, last) of other before position.
+   * @param position item that will follow the moved items, must not be in
+   * [first, last)
+   * @param other list that owns [first, last), may be this list
+   * @param first first item to move
+   * @param last item after the last item to move
+   *
+   * Only the boundary nodes are patched, this is O(1) unless
+   * constant_time_size is true and other is a different list, in which case
+   * the moved items are counted.
+   */
+  void splice(Iterator position, list &other, Iterator first, Iterator last) {
+    if (first == last) return;
+    if constexpr (Counter::enabled) {
+      if (&other != this) {
+        size_t n = 0;
+        for (Iterator i = first; i != last; ++i) n++;
+        other.Counter::size_dec(n);
+        Counter::size_inc(n);
+      }
+    }
+    Node *tail = last.node->prev;
+    internal::list_cut_range(first.node, tail);
+    internal::list_splice_range(first.node, tail, position.node);
+  }
+
+  /**
+   * move the items [position, end()) to the back of out.
+   * @param position first item to move
+   * @param out list receiving the items
+   *
+   * O(1) unless constant_time_size is true and out is a different list,
+   * in which case the moved items are counted.
+   */
+  void split_at(Iterator position, list &out) {
+    out.splice(out.end(), *this, position, end());
+  }
+
+  /**
+   * exchange the items of two lists in O(1).
+   * @param other list to swap with
+   */
+  void swap(list &other) {
+    if (&other == this) return;
+    // Swap the links one by one, a temporary Node would break hooks that
+    // store offsets relative to themselves.
+    Node *next = head_.next;
+    Node *prev = head_.prev;
+    head_.next = other.head_.next;
+    head_.prev = other.head_.prev;
+    other.head_.next = next;
+    other.head_.prev = prev;
+    std::swap(static_cast<Counter &>(*this), static_cast<Counter &>(other));
+    fix_boundary(&other.head_);
+    other.fix_boundary(&head_);
+  }
+
  private:
   static inline constexpr Node *get_node(T *item) {
     return &(item->*node_field);
@@ -214,6 +511,30 @@ class list {
   static inline constexpr T *get_owner(Node *member) {
     return internal::owner_of(member, node_field);
   }
+
+  static inline constexpr const T *get_owner(const Node *member) {
+    return internal::owner_of(member, node_field);
+  }
+
+  /**
+   * re-point the boundary nodes at head_ after head_ has been copied from
+   * the head at old_head.
+   */
+  void fix_boundary(Node *old_head) {
+    if (head_.next == old_head) {
+      internal::list_init_head(&head_);
+    } else {
+      head_.next->prev = &head_;
+      head_.prev->next = &head_;
+    }
+  }
+
+  template <typename Compare>
+  static inline auto node_compare(const Compare &comp) {
+    return [&comp](Node *a, Node *b) {
+      return comp(*get_owner(a), *get_owner(b));
+    };
+  }
 };
 
 }  // namespace intrusive_list
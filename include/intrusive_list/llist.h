@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+
+#include "atomic.h"
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+
+/**
+ * llist lock-free batch producer list, after the Linux kernel llist.
+ *
+ * Any number of threads add items with a single CAS each, and a consumer
+ * detaches the whole chain with one exchange and then walks it as an ordinary
+ * forward_list. Items come out newest first; call forward_list::reverse() on
+ * the detached chain to restore FIFO order.
+ *
+ * There is no single-item removal, so unlike atomic_stack no ABA protection
+ * is needed.
+ */
+template <typename T, forward_list_node T::*node_field>
+class llist {
+  std::atomic<forward_list_node *> first_;
+
+ public:
+  llist() noexcept : first_(nullptr) {}
+
+  llist(const llist &) = delete;
+  llist &operator=(const llist &) = delete;
+
+  /**
+   * insert item at the front of list, safe from any thread.
+   * @param item item to insert in list.
+   * @return true if the list was empty before, i.e. the consumer may need a
+   * wakeup.
+   */
+  bool add(T &item) { return add_batch(item, item); }
+
+  /**
+   * insert a prebuilt chain at the front of list with one CAS.
+   * @param first first item of the chain
+   * @param last last item of the chain, reached from first through the
+   * hooks; its hook is overwritten.
+   * @return true if the list was empty before.
+   */
+  bool add_batch(T &first, T &last) {
+    forward_list_node *first_node = get_node(&first);
+    forward_list_node *last_node = get_node(&last);
+    forward_list_node *old = first_.load(std::memory_order_relaxed);
+    do {
+      internal::atomic_store(&last_node->next, old, std::memory_order_relaxed);
+    } while (!first_.compare_exchange_weak(old, first_node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+    return old == nullptr;
+  }
+
+  /**
+   * detach all items with one atomic exchange.
+   * @return the detached items, newest first
+   */
+  forward_list<T, node_field> del_all() {
+    return forward_list<T, node_field>(
+        first_.exchange(nullptr, std::memory_order_acquire));
+  }
+
+  /**
+   * check if the list is empty, the answer may be stale immediately.
+   * @return true if list is empty.
+   */
+  bool empty() const {
+    return first_.load(std::memory_order_relaxed) == nullptr;
+  }
+
+ private:
+  static inline constexpr forward_list_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+};
+
+}  // namespace intrusive_list
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+
+#include "forward_list.h"
+#include "list.h"
+#include "unordered_set.h"
+
+namespace intrusive_list {
+namespace internal {
+
+struct lru_no_evict {
+  template <typename T>
+  void operator()(T &) const {}
+};
+
+}  // namespace internal
+
+/**
+ * lru_cache intrusive least-recently-used cache.
+ *
+ * Items carry a list hook (node_field) that keeps them in recency order, most
+ * recently used first, and a forward_list_node hook (index_field) that
+ * chains them into an intrusive unordered_set keyed by what KeyOf extracts
+ * from them. The cache never owns or copies items: evict_one() unlinks the
+ * least recently used item and hands it to OnEvict, which decides what
+ * happens to it.
+ *
+ * Lookup, promotion and eviction are O(1) and only relink hooks. The one
+ * allocation is the bucket array of the index, sized for the capacity up
+ * front and only reallocated when set_capacity() grows the cache.
+ */
+template <typename T, decltype(auto) node_field,
+          forward_list_node T::*index_field, typename KeyOf,
+          typename OnEvict = internal::lru_no_evict,
+          typename Hash = std::hash<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>,
+          typename KeyEqual = std::equal_to<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>>
+class lru_cache {
+ public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>;
+
+  explicit lru_cache(size_t capacity, OnEvict on_evict = OnEvict(),
+                     KeyOf key_of = KeyOf())
+      : index_(capacity + 1, Hash(), KeyEqual(), key_of),
+        capacity_(capacity),
+        on_evict_(on_evict) {}
+
+  lru_cache(const lru_cache &) = delete;
+  lru_cache &operator=(const lru_cache &) = delete;
+
+  /**
+   * look up an item and mark it most recently used.
+   * @param key key of the item
+   * @return the item, or nullptr if it is not cached
+   */
+  T *find(const key_type &key) {
+    T *item = index_.find(key);
+    if (item) touch(*item);
+    return item;
+  }
+
+  /**
+   * look up an item without changing the recency order.
+   * @param key key of the item
+   * @return the item, or nullptr if it is not cached
+   */
+  T *peek(const key_type &key) const { return index_.find(key); }
+
+  /**
+   * insert item as most recently used, evicting the least recently used
+   * item if the cache is over capacity.
+   * @param item item to insert, its hooks must not be linked
+   * @return false if an item with the same key is already cached, in which
+   * case nothing changes.
+   */
+  bool insert(T &item) {
+    // The index has room for capacity + 1 items, this never rehashes.
+    if (!index_.insert(item)) return false;
+    recency_.push_front(item);
+    if (recency_.size() > capacity_) evict_one();
+    return true;
+  }
+
+  /**
+   * mark a cached item most recently used.
+   * @param item item that is in this cache
+   */
+  void touch(T &item) {
+    recency_.remove_if_exists(item);
+    recency_.push_front(item);
+  }
+
+  /**
+   * remove a cached item without calling OnEvict.
+   * @param item item that is in this cache
+   */
+  void erase(T &item) {
+    index_.erase(item);
+    recency_.remove_if_exists(item);
+  }
+
+  /**
+   * remove an item by key without calling OnEvict.
+   * @param key key of the item
+   * @return the removed item, or nullptr if it is not cached
+   */
+  T *erase(const key_type &key) {
+    T *item = index_.erase(key);
+    if (item) recency_.remove_if_exists(*item);
+    return item;
+  }
+
+  /**
+   * remove the least recently used item and pass it to OnEvict.
+   * @return the evicted item, or nullptr if the cache is empty
+   */
+  T *evict_one() {
+    if (recency_.empty()) return nullptr;
+    T &victim = recency_.back();
+    recency_.pop_back();
+    index_.erase(victim);
+    on_evict_(victim);
+    return &victim;
+  }
+
+  /**
+   * change the capacity, evicting items until the cache fits.
+   * @param capacity new maximum number of items
+   */
+  void set_capacity(size_t capacity) {
+    capacity_ = capacity;
+    index_.reserve(capacity + 1);
+    while (recency_.size() > capacity_) evict_one();
+  }
+
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+  [[nodiscard]] size_t size() const { return recency_.size(); }
+  [[nodiscard]] bool empty() const { return recency_.empty(); }
+
+  /**
+   * return the least recently used item, i.e. the next to be evicted.
+   *
+   * Note cache need not empty.
+   */
+  T &lru() { return recency_.back(); }
+
+  /**
+   * return the most recently used item.
+   *
+   * Note cache need not empty.
+   */
+  T &mru() { return recency_.front(); }
+
+  using Iterator = typename list<T, node_field, true>::Iterator;
+
+  // Iterates from the most to the least recently used item.
+  Iterator begin() { return recency_.begin(); }
+  Iterator end() { return recency_.end(); }
+
+ private:
+  list<T, node_field, true> recency_;
+  unordered_set<T, index_field, KeyOf, Hash, KeyEqual> index_;
+  size_t capacity_;
+  OnEvict on_evict_;
+};
+
+}  // namespace intrusive_list
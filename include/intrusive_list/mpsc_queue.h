@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+
+#include "atomic.h"
+#include "common.h"
+#include "forward_list.h"
+#include "queue.h"
+
+namespace intrusive_list {
+
+/**
+ * mpsc_queue lock-free multi-producer single-consumer FIFO.
+ *
+ * Dmitry Vyukov's intrusive MPSC queue on forward_list_node hooks. push() is
+ * wait-free and may be called from any thread, pop() and pop_all() must only
+ * be called from one consumer thread at a time. Nothing is allocated, a stub
+ * node embedded in the queue keeps the list non-empty.
+ *
+ * The queue is not movable because producers hold on to its stub node.
+ */
+template <typename T, forward_list_node T::*node_field>
+class mpsc_queue {
+  // Producers swing head_, the consumer walks from tail_. Keep them on
+  // separate cache lines so the two sides do not false-share.
+  alignas(64) std::atomic<forward_list_node *> head_;
+  alignas(64) forward_list_node *tail_;
+  forward_list_node stub_;
+
+ public:
+  mpsc_queue() noexcept : head_(&stub_), tail_(&stub_), stub_({nullptr}) {}
+
+  mpsc_queue(const mpsc_queue &) = delete;
+  mpsc_queue &operator=(const mpsc_queue &) = delete;
+
+  /**
+   * insert item at the back of queue, safe from any thread.
+   * @param item item to insert in queue.
+   */
+  void push(T &item) { push_node(get_node(&item)); }
+
+  /**
+   * remove the first item in the queue, consumer only.
+   * @return first item, or nullptr if the queue is empty or the only pending
+   * producer has not finished linking its item yet.
+   */
+  T *pop() {
+    forward_list_node *tail = tail_;
+    forward_list_node *next =
+        internal::atomic_load(&tail->next, std::memory_order_acquire);
+
+    if (tail == &stub_) {
+      if (next == nullptr) return nullptr;
+      tail_ = next;
+      tail = next;
+      next = internal::atomic_load(&tail->next, std::memory_order_acquire);
+    }
+
+    if (next) {
+      tail_ = next;
+      return get_owner(tail);
+    }
+
+    // tail is the last linked node. Unless a producer is half way through
+    // push(), re-insert the stub behind it so that tail can be handed out.
+    if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+    push_node(&stub_);
+
+    next = internal::atomic_load(&tail->next, std::memory_order_acquire);
+    if (next) {
+      tail_ = next;
+      return get_owner(tail);
+    }
+    return nullptr;
+  }
+
+  /**
+   * remove every item that is fully linked, consumer only.
+   * @return the removed items in FIFO order
+   */
+  queue<T, node_field> pop_all() {
+    queue<T, node_field> batch;
+    while (T *item = pop()) {
+      batch.push_back(*item);
+    }
+    return batch;
+  }
+
+  /**
+   * check if the queue is empty, consumer only.
+   * @return true if queue is empty.
+   */
+  bool empty() const {
+    return tail_ == &stub_ && head_.load(std::memory_order_acquire) == &stub_;
+  }
+
+ private:
+  void push_node(forward_list_node *node) {
+    internal::atomic_store<forward_list_node *>(&node->next, nullptr,
+                                                std::memory_order_relaxed);
+    forward_list_node *prev = head_.exchange(node, std::memory_order_acq_rel);
+    internal::atomic_store(&prev->next, node, std::memory_order_release);
+  }
+
+  static inline constexpr forward_list_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(forward_list_node *member) {
+    return internal::owner_of(member, node_field);
+  }
+};
+
+}  // namespace intrusive_list
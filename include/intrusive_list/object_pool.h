@@ -0,0 +1,141 @@
+#pragma once
+
+#include <new>
+#include <utility>
+
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+
+/**
+ * object_pool fixed-size object pool.
+ *
+ * Memory is requested in slabs of objects_per_slab slots. A free slot holds
+ * a forward_list_node in its own storage, so unused slots are threaded
+ * through a forward_list free list and there is no per-object header:
+ * allocate() and deallocate() are a pop_front() and push_front(). Slabs are
+ * only returned when the pool is destroyed.
+ *
+ * allocate() and deallocate() hand out raw storage, create() and destroy()
+ * additionally construct and destroy the T. The pool does not track live
+ * objects, anything not destroyed before the pool goes away is not
+ * destructed.
+ */
+template <typename T>
+class object_pool {
+  union slot {
+    forward_list_node node;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  struct slab {
+    forward_list_node node;
+  };
+
+  // Slots follow the slab header, padded to the slot alignment.
+  static constexpr size_t kHeaderSize =
+      (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+  static constexpr size_t kAlignment =
+      alignof(slot) > alignof(slab) ? alignof(slot) : alignof(slab);
+
+ public:
+  /**
+   * @param objects_per_slab number of objects carved from each slab
+   */
+  explicit object_pool(size_t objects_per_slab = 64)
+      : objects_per_slab_(objects_per_slab ? objects_per_slab : 1) {}
+
+  object_pool(const object_pool &) = delete;
+  object_pool &operator=(const object_pool &) = delete;
+
+  ~object_pool() {
+    while (!slabs_.empty()) {
+      slab *s = &slabs_.front();
+      slabs_.pop_front();
+      ::operator delete(s, std::align_val_t(kAlignment));
+    }
+  }
+
+  /**
+   * get storage for one T, without constructing it.
+   * @return uninitialized storage for a T
+   */
+  T *allocate() {
+    if (free_.empty()) grow();
+    slot &s = free_.front();
+    free_.pop_front();
+    return reinterpret_cast<T *>(s.storage);
+  }
+
+  /**
+   * give back storage obtained from allocate(), without destroying the T.
+   * @param object storage to return
+   */
+  void deallocate(T *object) {
+    auto s = new (static_cast<void *>(object)) slot{};
+    free_.push_front(*s);
+  }
+
+  /**
+   * allocate and construct a T.
+   * @param args constructor arguments
+   * @return the new object
+   */
+  template <typename... Args>
+  T *create(Args &&...args) {
+    T *object = allocate();
+    try {
+      return new (object) T(std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(object);
+      throw;
+    }
+  }
+
+  /**
+   * destroy and deallocate an object obtained from create().
+   * @param object object to destroy
+   */
+  void destroy(T *object) {
+    object->~T();
+    deallocate(object);
+  }
+
+  /**
+   * return the number of slots in all slabs.
+   */
+  [[nodiscard]] size_t capacity() const {
+    return slab_count_ * objects_per_slab_;
+  }
+
+  /**
+   * return the number of slots currently free.
+   */
+  [[nodiscard]] size_t available() const { return free_.size(); }
+
+ private:
+  void grow() {
+    void *memory =
+        ::operator new(kHeaderSize + objects_per_slab_ * sizeof(slot),
+                       std::align_val_t(kAlignment));
+    auto s = new (memory) slab{};
+    slabs_.push_front(*s);
+    slab_count_++;
+
+    // Push in reverse so that allocations walk the slab in address order.
+    auto slots = reinterpret_cast<slot *>(static_cast<char *>(memory) +
+                                          kHeaderSize);
+    for (size_t i = objects_per_slab_; i-- > 0;) {
+      auto free_slot = new (&slots[i]) slot{};
+      free_.push_front(*free_slot);
+    }
+  }
+
+  forward_list<slot, &slot::node, true> free_;
+  forward_list<slab, &slab::node> slabs_;
+  size_t objects_per_slab_;
+  size_t slab_count_ = 0;
+};
+
+}  // namespace intrusive_list
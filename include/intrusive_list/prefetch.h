@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * prefetch - hint that the cache line at address will be read soon
+ * @address: any address, invalid ones do not fault
+ */
+static inline void prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#else
+  (void)address;
+#endif
+}
+
+}  // namespace internal
+
+/**
+ * for_each_prefetch - call f on every item of container, prefetching ahead
+ * @container: list, forward_list, queue, hlist or xor_list, any container
+ * whose Iterator exposes the current hook as node
+ * @distance: number of items to look ahead, 0 disables prefetching
+ * @f: called with each item in iteration order
+ *
+ * A plain range-for stalls on every hop: the next hook is only known once
+ * the current one has arrived from memory. Here a second iterator runs
+ * distance items ahead. Each time it steps onto a hook it prefetches that
+ * hook, which its next step reads one call of f later, and the owning
+ * item, which the loop reaches distance calls of f later.
+ *
+ * The lookahead still chases one pointer per item, so prefetching cannot
+ * make the walk itself faster; it only lets the misses overlap with f.
+ * It therefore pays only once f does enough work per item to hide a good
+ * part of a memory access, and gains nothing for a loop that merely reads
+ * a field or two. Measure with bench/prefetch_bench.cc before using it.
+ *
+ * f must not unlink items from the container.
+ */
+template <typename Container, typename F>
+static inline void for_each_prefetch(Container &container, size_t distance,
+                                     F &&f) {
+  auto end = container.end();
+  auto ahead = container.begin();
+  auto step_ahead = [&ahead, &end] {
+    ++ahead;
+    if (ahead != end) {
+      internal::prefetch(ahead.node);
+      internal::prefetch(&*ahead);
+    }
+  };
+  for (size_t i = 0; i < distance && ahead != end; ++i) step_ahead();
+
+  for (auto it = container.begin(); it != end; ++it) {
+    if (distance != 0 && ahead != end) step_ahead();
+    f(*it);
+  }
+}
+
+}  // namespace intrusive_list
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <type_traits>
+
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+
+/**
+ * queue singly linked list with a tail pointer.
+ *
+ * Uses the same one-pointer forward_list_node hook as forward_list, but also
+ * tracks the last item so that push_back and append are O(1). This makes it
+ * a FIFO with half the hook size of list. Like forward_list it takes any
+ * hook with a next field, e.g. relative_forward_list_node.
+ */
+template <typename T, decltype(auto) node_field,
+          bool constant_time_size = false>
+class queue : private internal::size_counter<constant_time_size> {
+  using Node = std::remove_reference_t<decltype((T *)nullptr->*node_field)>;
+  using Counter = internal::size_counter<constant_time_size>;
+
+  Node head_;
+  Node *tail_;
+
+ public:
+  queue() noexcept : tail_(&head_) { head_.next = nullptr; }
+
+  queue(const queue &) = delete;
+  queue &operator=(const queue &) = delete;
+
+  /**
+   * take over the items of other in O(1), leaving other empty.
+   */
+  queue(queue &&other) noexcept : queue() { append(other); }
+
+  /**
+   * drop the current items, then take over the items of other in O(1).
+   */
+  queue &operator=(queue &&other) noexcept {
+    if (&other != this) {
+      clear();
+      append(other);
+    }
+    return *this;
+  }
+
+  /**
+   * insert item at the front of queue.
+   * @param item item to insert in queue.
+   */
+  void push_front(T &item) {
+    Node *node = get_node(&item);
+    node->next = head_.next;
+    head_.next = node;
+    if (tail_ == &head_) tail_ = node;
+    Counter::size_inc();
+  }
+
+  /**
+   * insert item at the back of queue.
+   * @param item item to insert in queue.
+   */
+  void push_back(T &item) {
+    Node *node = get_node(&item);
+    node->next = nullptr;
+    tail_->next = node;
+    tail_ = node;
+    Counter::size_inc();
+  }
+
+  /**
+   * remove the first item in the queue.
+   */
+  void pop_front() {
+    head_.next = head_.next->next;
+    if (head_.next == nullptr) tail_ = &head_;
+    Counter::size_dec();
+  }
+
+  /**
+   * return first item in queue.
+   * @return first item in queue
+   *
+   * Note queue need not empty.
+   */
+  T &front() { return *get_owner(head_.next); }
+
+  /**
+   * return last item in queue.
+   * @return last item in queue
+   *
+   * Note queue need not empty.
+   */
+  T &back() { return *get_owner(tail_); }
+
+  /**
+   * move all items of other to the back of this queue, leaving other empty.
+   * @param other queue to take items from
+   */
+  void append(queue &other) {
+    if (&other == this || other.empty()) return;
+    tail_->next = other.head_.next;
+    tail_ = other.tail_;
+    Counter::size_inc(other.Counter::size_get());
+    other.clear();
+  }
+
+  /**
+   * move all items into a new queue, leaving this queue empty.
+   * @return queue holding all items
+   */
+  queue take_all() {
+    queue all;
+    all.append(*this);
+    return all;
+  }
+
+  /**
+   * drop all items in O(1), their hooks are left untouched.
+   */
+  void clear() {
+    head_.next = nullptr;
+    tail_ = &head_;
+    Counter::size_reset();
+  }
+
+  bool is_singular() { return head_.next && head_.next == tail_; }
+
+  /**
+   * check if the queue is empty.
+   * @return true if queue is empty.
+   */
+  bool empty() const { return head_.next == nullptr; }
+
+  /**
+   * return the number of items in the queue.
+   * @return number of items in the queue
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (const Node *node = head_.next; node; node = node->next) {
+        n++;
+      }
+      return n;
+    }
+  }
+
+  struct Iterator {
+    explicit Iterator(Node *v) : node(v) {}
+    explicit operator Node *() const { return node; }
+    inline bool operator!=(const Iterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const Iterator &rhs) const {
+      return node == rhs.node;
+    }
+    T &operator*() const { return *get_owner(node); }
+    T *operator->() const { return get_owner(node); }
+    Iterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+    Node *node;
+  };
+
+  struct ConstIterator {
+    explicit ConstIterator(const Node *v) : node(v) {}
+    ConstIterator(const Iterator &it) : node(it.node) {}
+    explicit operator const Node *() const { return node; }
+    inline bool operator!=(const ConstIterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const ConstIterator &rhs) const {
+      return node == rhs.node;
+    }
+    const T &operator*() const { return *get_owner(node); }
+    const T *operator->() const { return get_owner(node); }
+    ConstIterator &operator++() {
+      node = node->next;
+      return *this;
+    }
+    const Node *node;
+  };
+
+  Iterator begin() { return Iterator{head_.next}; }
+  ConstIterator begin() const { return ConstIterator{head_.next}; }
+  Iterator end() { return Iterator{nullptr}; }
+  ConstIterator end() const { return ConstIterator{nullptr}; }
+  ConstIterator cbegin() const { return begin(); }
+  ConstIterator cend() const { return end(); }
+
+ private:
+  static inline constexpr Node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(Node *member) {
+    return internal::owner_of(member, node_field);
+  }
+
+  static inline constexpr const T *get_owner(const Node *member) {
+    return internal::owner_of(member, node_field);
+  }
+};
+
+}  // namespace intrusive_list
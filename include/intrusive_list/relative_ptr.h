@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace intrusive_list {
+
+/**
+ * relative_ptr self-relative pointer, storing the distance from itself to
+ * the target instead of the target's address.
+ *
+ * With a 32-bit Offset a hook shrinks to half the size of a raw pointer on
+ * 64-bit targets, as long as the pointer and its target are less than 2 GiB
+ * apart, e.g. all nodes and list heads live in one arena. Offset 0 is a
+ * pointer to itself, which an empty list head needs, so nullptr is encoded
+ * as 1, never a valid distance between aligned nodes.
+ *
+ * Because only distances are stored, a list whose head and nodes all live in
+ * one memory segment stays valid wherever that segment is mapped, e.g. in a
+ * memfd or file shared by processes that map it at different addresses. Use
+ * a ptrdiff_t Offset for segments larger than 2 GiB.
+ *
+ * Copying re-encodes the target relative to the destination, so a
+ * relative_ptr behaves like a Node * as far as list and forward_list are
+ * concerned. Copying one to a place out of range of its target, such as a
+ * local variable on the stack, silently truncates the offset; keep working
+ * copies as Node *.
+ */
+template <typename Node, typename Offset = int32_t>
+class relative_ptr {
+  static constexpr Offset kNull = 1;
+
+  Offset offset_;
+
+ public:
+  relative_ptr() noexcept : offset_(kNull) {}
+  relative_ptr(Node *target) noexcept { set(target); }
+  relative_ptr(const relative_ptr &other) noexcept { set(other.get()); }
+
+  relative_ptr &operator=(const relative_ptr &other) noexcept {
+    set(other.get());
+    return *this;
+  }
+
+  relative_ptr &operator=(Node *target) noexcept {
+    set(target);
+    return *this;
+  }
+
+  [[nodiscard]] Node *get() const noexcept {
+    if (offset_ == kNull) return nullptr;
+    return reinterpret_cast<Node *>(reinterpret_cast<intptr_t>(this) +
+                                    offset_);
+  }
+
+  operator Node *() const noexcept { return get(); }
+  Node *operator->() const noexcept { return get(); }
+  Node &operator*() const noexcept { return *get(); }
+
+ private:
+  void set(Node *target) noexcept {
+    offset_ = target ? static_cast<Offset>(reinterpret_cast<intptr_t>(target) -
+                                           reinterpret_cast<intptr_t>(this))
+                     : kNull;
+  }
+};
+
+/**
+ * basic_relative_list_node list hook made of two self-relative pointers.
+ */
+template <typename Offset>
+struct basic_relative_list_node {
+  relative_ptr<basic_relative_list_node, Offset> next;
+  relative_ptr<basic_relative_list_node, Offset> prev;
+};
+
+/**
+ * basic_relative_forward_list_node forward_list hook made of one
+ * self-relative pointer.
+ */
+template <typename Offset>
+struct basic_relative_forward_list_node {
+  relative_ptr<basic_relative_forward_list_node, Offset> next;
+};
+
+/**
+ * 32-bit hooks, half the size of pointer hooks on 64-bit targets.
+ */
+using relative_list_node = basic_relative_list_node<int32_t>;
+using relative_forward_list_node = basic_relative_forward_list_node<int32_t>;
+
+/**
+ * pointer-sized hooks for shared memory segments of any size.
+ */
+using offset_list_node = basic_relative_list_node<ptrdiff_t>;
+using offset_forward_list_node = basic_relative_forward_list_node<ptrdiff_t>;
+
+}  // namespace intrusive_list
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+#include "common.h"
+#include "forward_list.h"
+#include "list.h"
+#include "llist.h"
+
+namespace intrusive_list {
+
+/**
+ * slab_allocator thread-caching fixed-size allocator with cross-thread
+ * frees.
+ *
+ * Memory comes in slabs of slab_size bytes aligned to slab_size, so the slab
+ * of any object is found by masking its address. Each thread allocates
+ * through its own thread_cache, which owns a set of slabs:
+ *
+ *  - free slots of owned slabs sit in the cache's magazine, a forward_list
+ *    stack threaded through the slots themselves, so a local allocate() or
+ *    deallocate() is a pop_front() or push_front() without atomics;
+ *  - the magazine holds at most kMagazineMax slots, beyond that half of it
+ *    goes back to the free lists of the slabs, and a slab whose slots are
+ *    all free again is handed to the allocator for any cache to adopt, so
+ *    one thread cannot hoard the memory other threads freed to it;
+ *  - a slot freed by a thread that does not own its slab goes to that
+ *    slab's remote free list, an llist, with a single CAS. The free that
+ *    makes that list non-empty also queues the slab with its owner under
+ *    the allocator mutex, so the owner collects only slabs that have
+ *    remote frees when its magazine runs dry;
+ *  - when a thread_cache is destroyed its slabs, including their free slots,
+ *    are handed off whole to the allocator and adopted by the next cache
+ *    that needs memory, instead of being stranded with the dead thread.
+ *
+ * Slabs are returned to the system only when the allocator is destroyed,
+ * which must happen after all of its thread caches are gone.
+ */
+template <typename T, size_t slab_size = 64 * 1024>
+class slab_allocator {
+  static_assert((slab_size & (slab_size - 1)) == 0,
+                "slab_size must be a power of two");
+
+  union slot {
+    forward_list_node node;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  struct slab_node {
+    slab_node *next;
+    slab_node *prev;
+  };
+
+ public:
+  class thread_cache;
+
+ private:
+  struct slab {
+    // In the allocator's abandoned list, or the owner's pending list.
+    forward_list_node link;
+    forward_list_node all_link;
+    // In the owner's list of slabs with local free slots.
+    slab_node partial_link;
+    // Changed under the allocator mutex only.
+    std::atomic<thread_cache *> owner;
+    llist<slot, &slot::node> remote_free;
+    forward_list<slot, &slot::node> local_free;
+    size_t local_count;
+    unsigned char *bump;
+    // Abandoned with remote frees nobody collected yet, under the mutex.
+    bool orphan_pending;
+  };
+
+  static constexpr size_t kHeaderSize =
+      (sizeof(slab) + alignof(slot) - 1) / alignof(slot) * alignof(slot);
+  static constexpr size_t kSlotsPerSlab =
+      (slab_size - kHeaderSize) / sizeof(slot);
+  // Upper bound of fresh slots, or slots from a slab's local free list,
+  // moved into a magazine at once, so a new slab is touched gradually.
+  static constexpr size_t kCarveBatch = 64;
+  // Magazine size past which deallocate() returns half to the slabs.
+  static constexpr size_t kMagazineMax = 4 * kCarveBatch;
+
+  static_assert(alignof(slab) <= slab_size && alignof(slot) <= slab_size);
+  static_assert(kSlotsPerSlab > 0, "slab_size is too small for T");
+
+ public:
+  slab_allocator() = default;
+  slab_allocator(const slab_allocator &) = delete;
+  slab_allocator &operator=(const slab_allocator &) = delete;
+
+  ~slab_allocator() {
+    while (!all_.empty()) {
+      slab *s = &all_.front();
+      all_.pop_front();
+      s->~slab();
+      ::operator delete(s, std::align_val_t(slab_size));
+    }
+  }
+
+  /**
+   * return the number of slabs obtained from the system so far.
+   */
+  [[nodiscard]] size_t slab_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slab_count_;
+  }
+
+  /**
+   * per-thread front end of a slab_allocator.
+   *
+   * Must only be used by one thread at a time. deallocate() accepts objects
+   * from any cache of the same allocator.
+   */
+  class thread_cache {
+   public:
+    explicit thread_cache(slab_allocator &allocator) : allocator_(allocator) {}
+
+    thread_cache(const thread_cache &) = delete;
+    thread_cache &operator=(const thread_cache &) = delete;
+
+    /**
+     * hand all owned slabs, with their free slots, back to the allocator.
+     *
+     * Finding them walks every slab of the allocator, which is fine once
+     * per thread.
+     */
+    ~thread_cache() {
+      while (!magazine_.empty()) {
+        slot &s = magazine_.front();
+        magazine_.pop_front();
+        slab *owner = slab_of(&s);
+        owner->local_free.push_front(s);
+        owner->local_count++;
+      }
+      partial_.clear();
+
+      std::lock_guard<std::mutex> lock(allocator_.mutex_);
+      while (!pending_.empty()) {
+        slab &s = pending_.front();
+        pending_.pop_front();
+        s.orphan_pending = true;
+      }
+      for (auto &s : allocator_.all_) {
+        if (s.owner.load(std::memory_order_relaxed) != this) continue;
+        s.owner.store(nullptr, std::memory_order_release);
+        allocator_.abandoned_.push_front(s);
+      }
+    }
+
+    /**
+     * get storage for one T, without constructing it.
+     * @return uninitialized storage for a T
+     */
+    T *allocate() {
+      if (magazine_.empty()) refill();
+      slot &s = magazine_.front();
+      magazine_.pop_front();
+      return reinterpret_cast<T *>(s.storage);
+    }
+
+    /**
+     * give back storage obtained from any cache of the same allocator.
+     * @param object storage to return
+     */
+    void deallocate(T *object) {
+      auto s = new (static_cast<void *>(object)) slot{};
+      slab *owner = slab_of(s);
+      if (owner->owner.load(std::memory_order_acquire) == this) {
+        magazine_.push_front(*s);
+        if (magazine_.size() > kMagazineMax) trim();
+      } else if (owner->remote_free.add(*s)) {
+        notify(*owner);
+      }
+    }
+
+   private:
+    void refill() {
+      // Slots other threads gave back to our slabs.
+      if (has_pending_.load(std::memory_order_acquire)) collect_pending();
+
+      // Then slots trimmed from the magazine earlier, then fresh slots,
+      // adopting or creating slabs as they run out. An adopted slab may
+      // have nothing free, hence the loop.
+      while (magazine_.empty()) {
+        if (!partial_.empty()) {
+          take_local(partial_.front());
+        } else if (current_ && carve(*current_)) {
+          break;
+        } else {
+          current_ = adopt_or_create();
+        }
+      }
+    }
+
+    /**
+     * queue s with its owner, after a remote free made its remote free
+     * list non-empty. Until the owner collects s, later remote frees to it
+     * do not get here, so s is queued once.
+     */
+    void notify(slab &s) {
+      std::lock_guard<std::mutex> lock(allocator_.mutex_);
+      thread_cache *owner = s.owner.load(std::memory_order_relaxed);
+      if (!owner) {
+        s.orphan_pending = true;
+        return;
+      }
+      owner->pending_.push_front(s);
+      owner->has_pending_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * take the remote frees of the queued slabs. Detaching them under the
+     * mutex orders it before the notify() of the next remote free, which
+     * queues the slab again.
+     */
+    void collect_pending() {
+      {
+        std::lock_guard<std::mutex> lock(allocator_.mutex_);
+        while (!pending_.empty()) {
+          slab &s = pending_.front();
+          pending_.pop_front();
+          auto remote = s.remote_free.del_all();
+          while (!remote.empty()) {
+            slot &free_slot = remote.front();
+            remote.pop_front();
+            magazine_.push_front(free_slot);
+          }
+        }
+        has_pending_.store(false, std::memory_order_relaxed);
+      }
+      if (magazine_.size() > kMagazineMax) trim();
+    }
+
+    /**
+     * return half of the magazine to the local free lists of the slabs,
+     * handing slabs that are entirely free back to the allocator.
+     */
+    void trim() {
+      while (magazine_.size() > kMagazineMax / 2) {
+        slot &free_slot = magazine_.front();
+        magazine_.pop_front();
+        slab &s = *slab_of(&free_slot);
+        if (s.local_free.empty()) partial_.push_back(s);
+        s.local_free.push_front(free_slot);
+        if (++s.local_count == carved(s)) release(s);
+      }
+    }
+
+    void take_local(slab &s) {
+      for (size_t n = 0; n < kCarveBatch && !s.local_free.empty(); ++n) {
+        slot &free_slot = s.local_free.front();
+        s.local_free.pop_front();
+        magazine_.push_front(free_slot);
+        s.local_count--;
+      }
+      if (s.local_free.empty()) partial_.remove_if_exists(s);
+    }
+
+    /**
+     * give a slab whose carved slots are all in its local free list to the
+     * allocator. Its remote free list is empty, so it is not pending.
+     */
+    void release(slab &s) {
+      partial_.remove_if_exists(s);
+      if (current_ == &s) current_ = nullptr;
+      std::lock_guard<std::mutex> lock(allocator_.mutex_);
+      s.owner.store(nullptr, std::memory_order_release);
+      allocator_.abandoned_.push_front(s);
+    }
+
+    static size_t carved(const slab &s) {
+      auto first = reinterpret_cast<const unsigned char *>(&s) + kHeaderSize;
+      return static_cast<size_t>(s.bump - first) / sizeof(slot);
+    }
+
+    bool carve(slab &s) {
+      auto end = reinterpret_cast<unsigned char *>(&s) + kHeaderSize +
+                 kSlotsPerSlab * sizeof(slot);
+      size_t n = 0;
+      for (; n < kCarveBatch && s.bump < end; ++n, s.bump += sizeof(slot)) {
+        magazine_.push_front(*new (s.bump) slot{});
+      }
+      return n > 0;
+    }
+
+    slab *adopt_or_create() {
+      slab *s = nullptr;
+      {
+        std::lock_guard<std::mutex> lock(allocator_.mutex_);
+        if (!allocator_.abandoned_.empty()) {
+          s = &allocator_.abandoned_.front();
+          allocator_.abandoned_.pop_front();
+          s->owner.store(this, std::memory_order_release);
+          if (s->orphan_pending) {
+            s->orphan_pending = false;
+            pending_.push_front(*s);
+            has_pending_.store(true, std::memory_order_relaxed);
+          }
+        }
+      }
+
+      if (s) {
+        if (!s->local_free.empty()) partial_.push_back(*s);
+        if (has_pending_.load(std::memory_order_acquire)) collect_pending();
+      } else {
+        void *memory = ::operator new(slab_size, std::align_val_t(slab_size));
+        s = new (memory) slab{};
+        s->bump = static_cast<unsigned char *>(memory) + kHeaderSize;
+
+        std::lock_guard<std::mutex> lock(allocator_.mutex_);
+        s->owner.store(this, std::memory_order_relaxed);
+        allocator_.all_.push_front(*s);
+        allocator_.slab_count_++;
+      }
+      return s;
+    }
+
+    slab_allocator &allocator_;
+    forward_list<slot, &slot::node, true> magazine_;
+    // Owned slabs with slots in their local free list.
+    list<slab, &slab::partial_link> partial_;
+    // Owned slabs with remote frees to collect, under the allocator mutex.
+    forward_list<slab, &slab::link> pending_;
+    std::atomic<bool> has_pending_{false};
+    slab *current_ = nullptr;
+  };
+
+ private:
+  static slab *slab_of(void *p) {
+    return reinterpret_cast<slab *>(reinterpret_cast<uintptr_t>(p) &
+                                    ~uintptr_t(slab_size - 1));
+  }
+
+  mutable std::mutex mutex_;
+  forward_list<slab, &slab::link> abandoned_;
+  forward_list<slab, &slab::all_link> all_;
+  size_t slab_count_ = 0;
+};
+
+}  // namespace intrusive_list
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+#include "index_list.h"
+
+namespace intrusive_list {
+
+/**
+ * soa_links link storage of soa_list, one next and one prev array indexed
+ * by slot.
+ *
+ * Each slot can be in at most one list sharing this storage at a time;
+ * items that need to be in several lists at once use one soa_links per
+ * membership.
+ */
+template <typename Index = uint32_t>
+class soa_links {
+  static_assert(std::is_unsigned_v<Index>, "Index must be unsigned");
+
+ public:
+  /**
+   * @param capacity number of slots, at most the largest Index value - 1
+   */
+  explicit soa_links(size_t capacity)
+      : next_(capacity, internal::index_unlinked<Index>),
+        prev_(capacity, internal::index_unlinked<Index>) {}
+
+  soa_links(const soa_links &) = delete;
+  soa_links &operator=(const soa_links &) = delete;
+
+  Index &next(Index slot) { return next_[slot]; }
+  Index &prev(Index slot) { return prev_[slot]; }
+  [[nodiscard]] Index next(Index slot) const { return next_[slot]; }
+  [[nodiscard]] Index prev(Index slot) const { return prev_[slot]; }
+
+  /**
+   * check if slot is linked into a list.
+   */
+  [[nodiscard]] bool is_linked(Index slot) const {
+    return next_[slot] != internal::index_unlinked<Index>;
+  }
+
+  [[nodiscard]] size_t capacity() const { return next_.size(); }
+
+  /**
+   * add unlinked slots at the end, e.g. after the item pool grew.
+   */
+  void grow(size_t capacity) {
+    if (capacity <= next_.size()) return;
+    next_.resize(capacity, internal::index_unlinked<Index>);
+    prev_.resize(capacity, internal::index_unlinked<Index>);
+  }
+
+ private:
+  std::vector<Index> next_;
+  std::vector<Index> prev_;
+};
+
+/**
+ * soa_list double linked list with the links kept outside the items.
+ *
+ * Items live in one array and are linked by slot through a soa_links,
+ * structure-of-arrays style, instead of through a hook in each item. Link
+ * traffic only touches the dense next/prev arrays: moving an iterator,
+ * splicing, rotating, erasing or counting never reads an item's cache line;
+ * only dereferencing an iterator does. Lists sharing one soa_links can
+ * exchange items in O(1).
+ *
+ * When constant_time_size is true the list keeps an element counter so that
+ * size() is O(1); otherwise size() walks the link array.
+ */
+template <typename T, typename Index = uint32_t,
+          bool constant_time_size = false>
+class soa_list : private internal::size_counter<constant_time_size> {
+  using Counter = internal::size_counter<constant_time_size>;
+
+  static constexpr Index kNil = internal::index_nil<Index>;
+
+  T *base_;
+  soa_links<Index> *links_;
+  Index head_ = kNil;
+  Index tail_ = kNil;
+
+ public:
+  /**
+   * @param base first element of the array holding the items
+   * @param links link storage with a slot for every element of the array
+   */
+  soa_list(T *base, soa_links<Index> &links) noexcept
+      : base_(base), links_(&links) {}
+
+  soa_list(const soa_list &) = delete;
+  soa_list &operator=(const soa_list &) = delete;
+
+  /**
+   * point the list at the new location of its array, e.g. after a
+   * std::vector grew.
+   */
+  void rebase(T *base) noexcept { base_ = base; }
+
+  /**
+   * insert item at the front of list.
+   * @param item item of the array to insert
+   */
+  void push_front(T &item) {
+    internal::index_list_insert(*links_, head_, tail_, slot_of(item), head_);
+    Counter::size_inc();
+  }
+
+  /**
+   * insert item at the back of list.
+   * @param item item of the array to insert
+   */
+  void push_back(T &item) {
+    internal::index_list_insert(*links_, head_, tail_, slot_of(item), kNil);
+    Counter::size_inc();
+  }
+
+  /**
+   * @param item item to remove
+   * @return true When the deletion is successful
+   * @return false When the item was not linked
+   */
+  bool remove_if_exists(T &item) {
+    Index slot = slot_of(item);
+    if (!links_->is_linked(slot)) return false;
+    internal::index_list_remove(*links_, head_, tail_, slot);
+    Counter::size_dec();
+    return true;
+  }
+
+  /**
+   * unlink all items, their slots are reset so remove_if_exists() on them
+   * returns false.
+   */
+  void clear() {
+    Index slot = head_;
+    while (slot != kNil) {
+      Index next = links_->next(slot);
+      links_->next(slot) = internal::index_unlinked<Index>;
+      links_->prev(slot) = internal::index_unlinked<Index>;
+      slot = next;
+    }
+    head_ = tail_ = kNil;
+    Counter::size_reset();
+  }
+
+  /**
+   * remove the first item in the list.
+   */
+  void pop_front() {
+    internal::index_list_remove(*links_, head_, tail_, head_);
+    Counter::size_dec();
+  }
+
+  /**
+   * remove the last item in the list.
+   */
+  void pop_back() {
+    internal::index_list_remove(*links_, head_, tail_, tail_);
+    Counter::size_dec();
+  }
+
+  /**
+   * return first item in list.
+   * @return first item in list
+   *
+   * Note list need not empty.
+   */
+  T &front() { return base_[head_]; }
+
+  /**
+   * return last item in list.
+   * @return last item in list
+   *
+   * Note list need not empty.
+   */
+  T &back() { return base_[tail_]; }
+
+  /**
+   * move the first item to the back.
+   */
+  void rotate_left() {
+    if (head_ == tail_) return;
+    Index slot = head_;
+    internal::index_list_cut(*links_, head_, tail_, slot, slot);
+    internal::index_list_insert(*links_, head_, tail_, slot, kNil);
+  }
+
+  /**
+   * move the last item to the front.
+   */
+  void rotate_right() {
+    if (head_ == tail_) return;
+    Index slot = tail_;
+    internal::index_list_cut(*links_, head_, tail_, slot, slot);
+    internal::index_list_insert(*links_, head_, tail_, slot, head_);
+  }
+
+  bool is_singular() { return head_ != kNil && head_ == tail_; }
+
+  /**
+   * check if the list is empty.
+   * @return true if list is empty.
+   */
+  [[nodiscard]] bool empty() const { return head_ == kNil; }
+
+  /**
+   * return the number of items in the list.
+   * @return number of items in the list
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (Index slot = head_; slot != kNil; slot = links_->next(slot)) n++;
+      return n;
+    }
+  }
+
+  struct Iterator {
+    Iterator(T *b, const soa_links<Index> *l, Index s)
+        : base(b), links(l), slot(s) {}
+    inline bool operator!=(const Iterator &rhs) const {
+      return slot != rhs.slot;
+    }
+    inline bool operator==(const Iterator &rhs) const {
+      return slot == rhs.slot;
+    }
+    T &operator*() const { return base[slot]; }
+    T *operator->() const { return &base[slot]; }
+    Iterator &operator++() {
+      slot = links->next(slot);
+      return *this;
+    }
+    T *base;
+    const soa_links<Index> *links;
+    Index slot;
+  };
+
+  Iterator begin() const { return Iterator{base_, links_, head_}; }
+  Iterator end() const { return Iterator{base_, links_, kNil}; }
+
+  Iterator erase(Iterator position) {
+    Iterator ret = Iterator(base_, links_, links_->next(position.slot));
+    internal::index_list_remove(*links_, head_, tail_, position.slot);
+    Counter::size_dec();
+    return ret;
+  }
+
+  /**
+   * insert item before position.
+   * @param position item that will follow item, end() to append
+   * @param item item of the array to insert
+   * @return iterator to item
+   */
+  Iterator insert(Iterator position, T &item) {
+    Index slot = slot_of(item);
+    internal::index_list_insert(*links_, head_, tail_, slot, position.slot);
+    Counter::size_inc();
+    return Iterator(base_, links_, slot);
+  }
+
+  /**
+   * move all items of other before position, leaving other empty.
+   * @param position item that will follow the moved items
+   * @param other list sharing the same soa_links
+   */
+  void splice(Iterator position, soa_list &other) {
+    if (&other == this || other.empty()) return;
+    internal::index_list_splice(*links_, head_, tail_, other.head_,
+                                other.tail_, position.slot);
+    other.head_ = other.tail_ = kNil;
+    Counter::size_inc(other.Counter::size_get());
+    other.Counter::size_reset();
+  }
+
+  /**
+   * move the items [first, last) of other before position.
+   * @param position item that will follow the moved items, must not be in
+   * [first, last)
+   * @param other list sharing the same soa_links that owns [first, last),
+   * may be this list
+   * @param first first item to move
+   * @param last item after the last item to move
+   *
+   * O(1) unless constant_time_size is true and other is a different list,
+   * in which case the moved slots are counted.
+   */
+  void splice(Iterator position, soa_list &other, Iterator first,
+              Iterator last) {
+    if (first == last) return;
+    if constexpr (Counter::enabled) {
+      if (&other != this) {
+        size_t n = 0;
+        for (Iterator i = first; i != last; ++i) n++;
+        other.Counter::size_dec(n);
+        Counter::size_inc(n);
+      }
+    }
+    Index tail = last.slot == kNil ? other.tail_ : links_->prev(last.slot);
+    internal::index_list_cut(*links_, other.head_, other.tail_, first.slot,
+                             tail);
+    internal::index_list_splice(*links_, head_, tail_, first.slot, tail,
+                                position.slot);
+  }
+
+  /**
+   * exchange the items of two lists sharing the same soa_links in O(1).
+   */
+  void swap(soa_list &other) {
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(static_cast<Counter &>(*this), static_cast<Counter &>(other));
+  }
+
+ private:
+  Index slot_of(const T &item) const {
+    return static_cast<Index>(&item - base_);
+  }
+};
+
+}  // namespace intrusive_list
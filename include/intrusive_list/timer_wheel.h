@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstdint>
+
+#include "list.h"
+
+namespace intrusive_list {
+
+/**
+ * timer_wheel hierarchical timing wheel, after the classic Linux kernel
+ * timer wheel.
+ *
+ * Timers are items with a list hook (node_field) and an expiry tick
+ * (expires_field). Every slot of the wheel is a list ring: the root level
+ * has 256 slots of one tick each, and four more levels of 64 slots each
+ * cover 2^14, 2^20, 2^26 and 2^32 ticks. Timers further out are parked in
+ * the last slot they fit in and re-placed as the wheel turns.
+ *
+ * schedule() and cancel() are O(1) and never allocate. advance() runs every
+ * tick up to the new time: each tick splices its whole root slot out in O(1)
+ * and expires it, and every 256 ticks one slot of the next level is
+ * cascaded down. A bitmap of possibly non-empty root slots lets advance()
+ * skip idle ticks, so it costs one step per 256 ticks when nothing is due.
+ *
+ * Timer hooks must be zero-initialized before the first schedule(), since
+ * cancel() relies on list::remove_if_exists().
+ */
+template <typename T, decltype(auto) node_field, uint64_t T::*expires_field>
+class timer_wheel {
+  static constexpr int kRootBits = 8;
+  static constexpr int kLevelBits = 6;
+  static constexpr int kLevels = 4;
+  static constexpr uint64_t kRootSize = uint64_t(1) << kRootBits;
+  static constexpr uint64_t kLevelSize = uint64_t(1) << kLevelBits;
+  static constexpr uint64_t kRootMask = kRootSize - 1;
+  static constexpr uint64_t kLevelMask = kLevelSize - 1;
+  static constexpr uint64_t kMaxTimeout =
+      (uint64_t(1) << (kRootBits + kLevels * kLevelBits)) - 1;
+
+  using Slot = list<T, node_field>;
+
+ public:
+  /**
+   * @param now tick the wheel starts at
+   */
+  explicit timer_wheel(uint64_t now = 0) : now_(now) {}
+
+  /**
+   * arm timer, re-arming it if it is already scheduled.
+   * @param timer timer to arm
+   * @param expires absolute tick at which it expires, ticks that have
+   * already been processed expire on the next advance()
+   */
+  void schedule(T &timer, uint64_t expires) {
+    cancel(timer);
+    timer.*expires_field = expires;
+    add(timer);
+    count_++;
+  }
+
+  /**
+   * disarm timer.
+   * @param timer timer to disarm
+   * @return false if the timer was not scheduled
+   */
+  bool cancel(T &timer) {
+    // remove_if_exists() only touches the hook, so any slot can unlink it.
+    if (!root_[0].remove_if_exists(timer)) return false;
+    count_--;
+    return true;
+  }
+
+  /**
+   * process every tick up to and including now.
+   * @param now current tick
+   * @param on_expire called with each expired timer, which is already
+   * unlinked and may be scheduled again or cancel other timers
+   * @return number of expired timers
+   */
+  template <typename F>
+  size_t advance(uint64_t now, F &&on_expire) {
+    size_t expired = 0;
+    while (now_ <= now) {
+      if (count_ == 0) {
+        now_ = now + 1;
+        break;
+      }
+
+      uint64_t index = now_ & kRootMask;
+      if (index == 0) {
+        for (int level = 0; level < kLevels; ++level) {
+          if (cascade(level) != 0) break;
+        }
+      }
+
+      uint64_t pending = next_pending(index);
+      if (pending != index) {
+        // Jump to the next slot that may hold timers, or to the next
+        // cascade at the end of this round.
+        uint64_t tick = now_ - index + pending;
+        if (tick > now) {
+          now_ = now + 1;
+          break;
+        }
+        now_ = tick;
+        continue;
+      }
+
+      pending_[index / 64] &= ~(uint64_t(1) << (index % 64));
+      now_++;
+
+      Slot work;
+      work.splice(work.end(), root_[index]);
+      while (!work.empty()) {
+        T &timer = work.front();
+        work.pop_front();
+        count_--;
+        expired++;
+        on_expire(timer);
+      }
+    }
+    return expired;
+  }
+
+  /**
+   * return the next tick that advance() will process.
+   */
+  [[nodiscard]] uint64_t now() const { return now_; }
+
+  [[nodiscard]] size_t size() const { return count_; }
+  [[nodiscard]] bool empty() const { return count_ == 0; }
+
+ private:
+  void add(T &timer) {
+    uint64_t expires = timer.*expires_field;
+    uint64_t delta = expires - now_;
+    Slot *slot;
+
+    if (static_cast<int64_t>(delta) < 0 || delta < kRootSize) {
+      uint64_t index = (delta < kRootSize ? expires : now_) & kRootMask;
+      pending_[index / 64] |= uint64_t(1) << (index % 64);
+      slot = &root_[index];
+    } else {
+      int level = 0;
+      while (level < kLevels - 1 && delta >= level_span(level + 1)) level++;
+      if (delta > kMaxTimeout) expires = now_ + kMaxTimeout;
+      slot = &levels_[level][level_index(expires, level)];
+    }
+    slot->push_back(timer);
+  }
+
+  /**
+   * move the timers of the current slot of level down the wheel.
+   * @return index of that slot, 0 means the next level is due as well
+   */
+  uint64_t cascade(int level) {
+    uint64_t index = level_index(now_, level);
+    Slot work;
+    work.splice(work.end(), levels_[level][index]);
+    while (!work.empty()) {
+      T &timer = work.front();
+      work.pop_front();
+      add(timer);
+    }
+    return index;
+  }
+
+  /**
+   * return the first root slot at or after index that may hold timers, or
+   * kRootSize if there is none. Bits of slots emptied by cancel() are only
+   * cleared once the slot is processed.
+   */
+  uint64_t next_pending(uint64_t index) const {
+    for (uint64_t word = index / 64; word < kRootSize / 64; ++word) {
+      uint64_t bits = pending_[word];
+      if (word == index / 64) bits &= ~uint64_t(0) << (index % 64);
+      if (bits) return word * 64 + internal::find_first_set(bits);
+    }
+    return kRootSize;
+  }
+
+  static constexpr uint64_t level_span(int level) {
+    return uint64_t(1) << (kRootBits + level * kLevelBits);
+  }
+
+  static constexpr uint64_t level_index(uint64_t tick, int level) {
+    return (tick >> (kRootBits + level * kLevelBits)) & kLevelMask;
+  }
+
+  Slot root_[kRootSize];
+  uint64_t pending_[kRootSize / 64] = {};
+  Slot levels_[kLevels][kLevelSize];
+  uint64_t now_;
+  size_t count_ = 0;
+};
+
+}  // namespace intrusive_list
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common.h"
+#include "list.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * find_last_set - index of the most significant set bit
+ * @word: non-zero word
+ */
+static inline int find_last_set(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return 63 - __builtin_clzll(word);
+#else
+  int index = 63;
+  while (!(word >> index)) index--;
+  return index;
+#endif
+}
+
+}  // namespace internal
+
+/**
+ * tlsf_allocator Two-Level Segregated Fit allocator over a caller-provided
+ * arena, after Masmano et al. and Matthew Conte's tlsf.
+ *
+ * Free blocks carry a list hook in their payload and live in one of
+ * kFirstLevels x kSecondLevels size-class lists: the first level splits
+ * sizes by power of two, the second level splits each power of two into 32
+ * linear ranges. Two bitmaps record which lists are non-empty, so finding a
+ * fitting list is a couple of bit scans, and allocate(), deallocate() and
+ * coalescing with both physical neighbours are O(1). The one exception is
+ * an allocate() that no larger class can serve: it then scans the list of
+ * its own class, so that e.g. the largest free block can still be handed
+ * out whole.
+ *
+ * Every block starts with a header holding its physical predecessor and its
+ * size; the arena ends with a zero-sized sentinel that is never free. The
+ * allocator itself does not allocate and is not thread-safe.
+ */
+class tlsf_allocator {
+  struct free_link {
+    free_link *next;
+    free_link *prev;
+  };
+
+  struct block {
+    block *prev_phys;
+    // Payload size, bit 0 set while the block is free.
+    size_t size;
+    // Start of the payload, only used while the block is free.
+    free_link link;
+  };
+
+  using free_list = list<block, &block::link>;
+
+  static constexpr size_t kAlign = 2 * sizeof(void *);
+  static constexpr size_t kHeaderSize = offsetof(block, link);
+  static constexpr size_t kMinPayload = sizeof(free_link);
+  static constexpr size_t kFreeBit = 1;
+
+  static constexpr int kSecondLevelLog2 = 5;
+  static constexpr int kSecondLevels = 1 << kSecondLevelLog2;
+  static constexpr int kAlignLog2 = sizeof(void *) == 8 ? 4 : 3;
+  // Sizes below kSmallBlock share first level 0, split linearly.
+  static constexpr int kFirstLevelShift = kSecondLevelLog2 + kAlignLog2;
+  static constexpr size_t kSmallBlock = size_t(1) << kFirstLevelShift;
+  static constexpr int kFirstLevelMax = sizeof(void *) == 8 ? 40 : 30;
+  static constexpr int kFirstLevels = kFirstLevelMax - kFirstLevelShift + 1;
+
+  static_assert(kHeaderSize % kAlign == 0);
+  static_assert(kMinPayload % kAlign == 0);
+
+ public:
+  /**
+   * largest single allocation the size classes can hold.
+   */
+  static constexpr size_t kMaxAllocation =
+      (size_t(1) << kFirstLevelMax) - kAlign;
+
+  /**
+   * @param memory start of the arena
+   * @param bytes size of the arena, the part beyond what the size classes
+   * can describe is ignored
+   */
+  tlsf_allocator(void *memory, size_t bytes) {
+    auto begin = align_up(reinterpret_cast<uintptr_t>(memory));
+    auto end = reinterpret_cast<uintptr_t>(memory) + bytes;
+    if (end < begin + 2 * kHeaderSize + kMinPayload) return;
+
+    size_t payload = (end - begin - 2 * kHeaderSize) & ~(kAlign - 1);
+    if (payload > kMaxAllocation) payload = kMaxAllocation;
+
+    auto first = reinterpret_cast<block *>(begin);
+    first->prev_phys = nullptr;
+    first->size = payload;
+
+    auto sentinel = next_phys(first);
+    sentinel->prev_phys = first;
+    sentinel->size = 0;
+
+    first->link = {nullptr, nullptr};
+    insert_free(first);
+    free_bytes_ = payload;
+  }
+
+  tlsf_allocator(const tlsf_allocator &) = delete;
+  tlsf_allocator &operator=(const tlsf_allocator &) = delete;
+
+  /**
+   * allocate size bytes aligned to 2 * sizeof(void *).
+   * @param size requested size
+   * @return the memory, or nullptr if no free block is large enough
+   */
+  void *allocate(size_t size) {
+    if (size > kMaxAllocation) return nullptr;
+    size = size < kMinPayload ? kMinPayload : align_up(size);
+
+    block *b = find_free(size);
+    if (!b) return nullptr;
+    remove_free(b);
+
+    // Split off the tail if it can hold a block of its own.
+    size_t available = block_size(b);
+    if (available >= size + kHeaderSize + kMinPayload) {
+      auto rest = reinterpret_cast<block *>(
+          reinterpret_cast<char *>(b) + kHeaderSize + size);
+      rest->prev_phys = b;
+      rest->size = available - size - kHeaderSize;
+      next_phys(rest)->prev_phys = rest;
+      b->size = size;
+      rest->link = {nullptr, nullptr};
+      insert_free(rest);
+      free_bytes_ -= kHeaderSize;
+    } else {
+      b->size = available;
+    }
+
+    free_bytes_ -= block_size(b);
+    return &b->link;
+  }
+
+  /**
+   * return memory obtained from allocate(), coalescing it with free
+   * neighbours.
+   * @param ptr memory to free, nullptr is ignored
+   */
+  void deallocate(void *ptr) {
+    if (!ptr) return;
+    auto b = block_of(ptr);
+    free_bytes_ += block_size(b);
+    b->link = {nullptr, nullptr};
+
+    block *prev = b->prev_phys;
+    if (prev && is_free(prev)) {
+      remove_free(prev);
+      prev->size = block_size(prev) + kHeaderSize + block_size(b);
+      next_phys(prev)->prev_phys = prev;
+      free_bytes_ += kHeaderSize;
+      b = prev;
+    }
+
+    block *next = next_phys(b);
+    if (is_free(next)) {
+      remove_free(next);
+      b->size = block_size(b) + kHeaderSize + block_size(next);
+      next_phys(b)->prev_phys = b;
+      free_bytes_ += kHeaderSize;
+    }
+
+    insert_free(b);
+  }
+
+  /**
+   * return the usable size of an allocation, at least the requested size.
+   */
+  static size_t usable_size(const void *ptr) {
+    return block_size(block_of(const_cast<void *>(ptr)));
+  }
+
+  /**
+   * return the total payload of all free blocks.
+   */
+  [[nodiscard]] size_t free_bytes() const { return free_bytes_; }
+
+  /**
+   * return the largest size allocate() can currently satisfy.
+   */
+  [[nodiscard]] size_t largest_free_block() {
+    if (!first_level_map_) return 0;
+    int fl = internal::find_last_set(first_level_map_);
+    int sl = internal::find_last_set(second_level_map_[fl]);
+    size_t largest = 0;
+    for (auto &b : free_lists_[fl][sl]) {
+      if (block_size(&b) > largest) largest = block_size(&b);
+    }
+    return largest;
+  }
+
+ private:
+  static inline size_t align_up(size_t size) {
+    return (size + kAlign - 1) & ~(kAlign - 1);
+  }
+
+  static inline size_t block_size(const block *b) {
+    return b->size & ~kFreeBit;
+  }
+
+  static inline bool is_free(const block *b) { return b->size & kFreeBit; }
+
+  static inline block *next_phys(block *b) {
+    return reinterpret_cast<block *>(reinterpret_cast<char *>(b) +
+                                     kHeaderSize + block_size(b));
+  }
+
+  static inline block *block_of(void *ptr) {
+    return internal::owner_of(static_cast<free_link *>(ptr), &block::link);
+  }
+
+  /**
+   * size class of a block size, rounding down.
+   */
+  static inline void mapping_insert(size_t size, int *fl, int *sl) {
+    if (size < kSmallBlock) {
+      *fl = 0;
+      *sl = static_cast<int>(size / (kSmallBlock / kSecondLevels));
+    } else {
+      int bit = internal::find_last_set(size);
+      *sl = static_cast<int>((size >> (bit - kSecondLevelLog2)) ^
+                             (size_t(1) << kSecondLevelLog2));
+      *fl = bit - (kFirstLevelShift - 1);
+    }
+  }
+
+  /**
+   * first free block of a class whose blocks all fit size. When there is
+   * none, e.g. because size is in the last class and rounding it up goes
+   * past the bitmap, fall back to the first block of size's own class that
+   * is large enough.
+   * @return the block, or nullptr if no free block fits
+   */
+  block *find_free(size_t size) {
+    // Round up to the next class boundary so any block of the class fits.
+    size_t rounded = size;
+    if (size >= kSmallBlock) {
+      rounded += (size_t(1) << (internal::find_last_set(size) -
+                                kSecondLevelLog2)) -
+                 1;
+    }
+    int fl, sl;
+    mapping_insert(rounded, &fl, &sl);
+    if (fl < kFirstLevels) {
+      uint32_t sl_map = second_level_map_[fl] & (~uint32_t(0) << sl);
+      if (!sl_map) {
+        uint64_t fl_map = first_level_map_ & (~uint64_t(0) << (fl + 1));
+        if (fl_map) {
+          fl = internal::find_first_set(fl_map);
+          sl_map = second_level_map_[fl];
+        }
+      }
+      if (sl_map) {
+        return &free_lists_[fl][internal::find_first_set(sl_map)].front();
+      }
+    }
+
+    mapping_insert(size, &fl, &sl);
+    for (auto &b : free_lists_[fl][sl]) {
+      if (block_size(&b) >= size) return &b;
+    }
+    return nullptr;
+  }
+
+  void insert_free(block *b) {
+    int fl, sl;
+    mapping_insert(block_size(b), &fl, &sl);
+    b->size |= kFreeBit;
+    free_lists_[fl][sl].push_front(*b);
+    first_level_map_ |= uint64_t(1) << fl;
+    second_level_map_[fl] |= uint32_t(1) << sl;
+  }
+
+  void remove_free(block *b) {
+    int fl, sl;
+    mapping_insert(block_size(b), &fl, &sl);
+    b->size &= ~kFreeBit;
+    free_lists_[fl][sl].remove_if_exists(*b);
+    if (free_lists_[fl][sl].empty()) {
+      second_level_map_[fl] &= ~(uint32_t(1) << sl);
+      if (!second_level_map_[fl]) first_level_map_ &= ~(uint64_t(1) << fl);
+    }
+  }
+
+  uint64_t first_level_map_ = 0;
+  uint32_t second_level_map_[kFirstLevels] = {};
+  free_list free_lists_[kFirstLevels][kSecondLevels];
+  size_t free_bytes_ = 0;
+};
+
+}  // namespace intrusive_list
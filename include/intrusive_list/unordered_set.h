@@ -0,0 +1,349 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#include "common.h"
+#include "forward_list.h"
+
+namespace intrusive_list {
+namespace internal {
+
+/**
+ * hash_bucket_bits - log2 of the smallest power of two >= count
+ * @count: requested number of buckets
+ */
+static inline int hash_bucket_bits(size_t count) {
+  int bits = 0;
+  while ((size_t(1) << bits) < count) bits++;
+  return bits;
+}
+
+/**
+ * hash_bucket_index - map a hash to one of 2^bits buckets
+ * @hash: hash of the key
+ * @bits: log2 of the bucket count
+ *
+ * Fibonacci hashing: multiply by 2^N/phi and keep the top bits, so weak
+ * hashes such as the identity std::hash of integers still spread over all
+ * buckets. Because the top bits are kept, doubling the bucket count sends
+ * the items of bucket i to buckets 2i and 2i + 1.
+ */
+static inline size_t hash_bucket_index(size_t hash, int bits) {
+  constexpr int kHashBits = sizeof(size_t) * 8;
+  constexpr size_t kGolden = sizeof(size_t) == 8
+                                 ? static_cast<size_t>(0x9E3779B97F4A7C15ull)
+                                 : static_cast<size_t>(0x9E3779B9u);
+  if (bits == 0) return 0;
+  return (hash * kGolden) >> (kHashBits - bits);
+}
+
+/**
+ * hash_chains - chain handling shared by the intrusive hash tables
+ *
+ * Buckets are forward_list_node heads whose chains link the items through
+ * node_field. Which bucket a hash maps to is up to the derived table, which
+ * passes buckets in; everything that walks or relinks a chain lives here.
+ */
+template <typename T, forward_list_node T::*node_field, typename KeyOf,
+          typename Hash, typename KeyEqual>
+class hash_chains {
+ public:
+  using key_type =
+      std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>;
+
+  [[nodiscard]] size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+ protected:
+  hash_chains(Hash hash, KeyEqual equal, KeyOf key_of)
+      : hash_(hash), equal_(equal), key_of_(key_of) {}
+
+  static std::unique_ptr<forward_list_node[]> allocate_buckets(int bits) {
+    return std::unique_ptr<forward_list_node[]>(
+        new forward_list_node[size_t(1) << bits]());
+  }
+
+  decltype(auto) key_of(const T &item) const { return key_of_(item); }
+  size_t hash_key(const key_type &key) const { return hash_(key); }
+
+  forward_list_node *find_in_bucket(const forward_list_node *bucket,
+                                    const key_type &key) const {
+    for (auto node = bucket->next; node; node = node->next) {
+      if (equal_(key_of_(*get_owner(node)), key)) return node;
+    }
+    return nullptr;
+  }
+
+  /**
+   * link item at the front of bucket.
+   */
+  void link(forward_list_node *bucket, T &item) {
+    auto node = get_node(&item);
+    node->next = bucket->next;
+    bucket->next = node;
+    size_++;
+  }
+
+  /**
+   * unlink the item with key from bucket.
+   * @return the unlinked item, or nullptr if it is not in bucket
+   */
+  T *unlink_key(forward_list_node *bucket, const key_type &key) {
+    forward_list_node *prev = bucket;
+    for (auto node = prev->next; node; prev = node, node = node->next) {
+      if (equal_(key_of_(*get_owner(node)), key)) {
+        prev->next = node->next;
+        size_--;
+        return get_owner(node);
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * unlink item from bucket.
+   * @return false if item is not in bucket
+   */
+  bool unlink_item(forward_list_node *bucket, T &item) {
+    auto target = get_node(&item);
+    forward_list_node *prev = bucket;
+    for (auto node = prev->next; node; prev = node, node = node->next) {
+      if (node == target) {
+        prev->next = node->next;
+        size_--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * move every item of chain into the bucket array buckets of 2^bits
+   * buckets, leaving chain empty.
+   */
+  void move_chain(forward_list_node *chain, forward_list_node *buckets,
+                  int bits) const {
+    auto node = chain->next;
+    chain->next = nullptr;
+    while (node) {
+      auto next = node->next;
+      auto bucket = &buckets[hash_bucket_index(
+          hash_(key_of_(*get_owner(node))), bits)];
+      node->next = bucket->next;
+      bucket->next = node;
+      node = next;
+    }
+  }
+
+  /**
+   * empty count buckets and reset the size, the hooks are left untouched.
+   */
+  void clear_buckets(forward_list_node *buckets, size_t count) {
+    for (size_t i = 0; i < count; ++i) buckets[i].next = nullptr;
+    size_ = 0;
+  }
+
+  static inline constexpr forward_list_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(forward_list_node *member) {
+    return owner_of(member, node_field);
+  }
+
+ private:
+  size_t size_ = 0;
+  Hash hash_;
+  KeyEqual equal_;
+  KeyOf key_of_;
+};
+
+/**
+ * hash_iterator - iterator over the items of a hash table
+ *
+ * Table provides iteration_end(), the number of buckets to visit, and
+ * iteration_bucket(i), the i-th of them.
+ */
+template <typename T, forward_list_node T::*node_field, typename Table>
+struct hash_iterator {
+  hash_iterator(const Table *set, size_t bucket, forward_list_node *v)
+      : set(set), bucket(bucket), node(v) {
+    skip_empty();
+  }
+  inline bool operator!=(const hash_iterator &rhs) const {
+    return node != rhs.node;
+  }
+  inline bool operator==(const hash_iterator &rhs) const {
+    return node == rhs.node;
+  }
+  T &operator*() const { return *owner_of(node, node_field); }
+  T *operator->() const { return owner_of(node, node_field); }
+  hash_iterator &operator++() {
+    node = node->next;
+    skip_empty();
+    return *this;
+  }
+  const Table *set;
+  size_t bucket;
+  forward_list_node *node;
+
+ private:
+  void skip_empty() {
+    while (!node && ++bucket < set->iteration_end()) {
+      node = set->iteration_bucket(bucket)->next;
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * unordered_set intrusive chained hash table.
+ *
+ * Items carry a forward_list_node hook (node_field) that chains them into
+ * their bucket, and are identified by the key that KeyOf extracts from them.
+ * Keys are unique. The only allocation is the power-of-two bucket array of
+ * one pointer per bucket, which doubles when the load factor exceeds 1.
+ *
+ * Used with a KeyOf that returns a member, this is also the intrusive
+ * equivalent of an unordered_map.
+ */
+template <typename T, forward_list_node T::*node_field, typename KeyOf,
+          typename Hash = std::hash<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>,
+          typename KeyEqual = std::equal_to<
+              std::decay_t<std::invoke_result_t<const KeyOf &, const T &>>>>
+class unordered_set
+    : private internal::hash_chains<T, node_field, KeyOf, Hash, KeyEqual> {
+  using Chains = internal::hash_chains<T, node_field, KeyOf, Hash, KeyEqual>;
+  friend struct internal::hash_iterator<T, node_field, unordered_set>;
+
+ public:
+  using typename Chains::key_type;
+  using Chains::empty;
+  using Chains::size;
+
+  explicit unordered_set(size_t bucket_count = 16, Hash hash = Hash(),
+                         KeyEqual equal = KeyEqual(), KeyOf key_of = KeyOf())
+      : Chains(hash, equal, key_of) {
+    reset_buckets(bucket_count);
+  }
+
+  unordered_set(const unordered_set &) = delete;
+  unordered_set &operator=(const unordered_set &) = delete;
+
+  /**
+   * insert item, growing the bucket array if needed.
+   * @param item item to insert, its hook must not be linked
+   * @return false if an item with the same key is already present, in which
+   * case nothing changes.
+   */
+  bool insert(T &item) {
+    const key_type &key = Chains::key_of(item);
+    size_t hash = Chains::hash_key(key);
+    forward_list_node *bucket = &buckets_[bucket_index(hash)];
+    if (Chains::find_in_bucket(bucket, key)) return false;
+
+    if (size() >= bucket_count()) {
+      rehash(bucket_count() * 2);
+      bucket = &buckets_[bucket_index(hash)];
+    }
+
+    Chains::link(bucket, item);
+    return true;
+  }
+
+  /**
+   * look up an item by key.
+   * @param key key of the item
+   * @return the item, or nullptr if it is not present
+   */
+  T *find(const key_type &key) const {
+    auto node = Chains::find_in_bucket(locate(key), key);
+    return node ? Chains::get_owner(node) : nullptr;
+  }
+
+  bool contains(const key_type &key) const { return find(key) != nullptr; }
+
+  /**
+   * remove an item by key.
+   * @param key key of the item
+   * @return the removed item, or nullptr if it is not present
+   */
+  T *erase(const key_type &key) {
+    return Chains::unlink_key(locate(key), key);
+  }
+
+  /**
+   * remove a specific item.
+   * @param item item to remove
+   * @return false if item is not in this set
+   */
+  bool erase(T &item) {
+    return Chains::unlink_item(locate(Chains::key_of(item)), item);
+  }
+
+  /**
+   * change the bucket count, relinking every item.
+   * @param count new bucket count, rounded up to a power of two and to at
+   * least size()
+   */
+  void rehash(size_t count) {
+    if (count < size()) count = size();
+    auto old_buckets = std::move(buckets_);
+    size_t old_count = bucket_count();
+    reset_buckets(count);
+
+    for (size_t i = 0; i < old_count; ++i) {
+      Chains::move_chain(&old_buckets[i], buckets_.get(), bits_);
+    }
+  }
+
+  /**
+   * make room for count items without further rehashing.
+   * @param count expected number of items
+   */
+  void reserve(size_t count) {
+    if (count > bucket_count()) rehash(count);
+  }
+
+  /**
+   * drop all items, their hooks are left untouched.
+   */
+  void clear() { Chains::clear_buckets(buckets_.get(), bucket_count()); }
+
+  [[nodiscard]] size_t bucket_count() const { return size_t(1) << bits_; }
+  [[nodiscard]] float load_factor() const {
+    return static_cast<float>(size()) / static_cast<float>(bucket_count());
+  }
+
+  using Iterator = internal::hash_iterator<T, node_field, unordered_set>;
+
+  Iterator begin() const { return Iterator{this, 0, buckets_[0].next}; }
+  Iterator end() const { return Iterator{this, bucket_count(), nullptr}; }
+
+ private:
+  void reset_buckets(size_t count) {
+    bits_ = internal::hash_bucket_bits(count ? count : 1);
+    buckets_ = Chains::allocate_buckets(bits_);
+  }
+
+  size_t bucket_index(size_t hash) const {
+    return internal::hash_bucket_index(hash, bits_);
+  }
+
+  forward_list_node *locate(const key_type &key) const {
+    return &buckets_[bucket_index(Chains::hash_key(key))];
+  }
+
+  size_t iteration_end() const { return bucket_count(); }
+
+  forward_list_node *iteration_bucket(size_t i) const { return &buckets_[i]; }
+
+  std::unique_ptr<forward_list_node[]> buckets_;
+  int bits_ = 0;
+};
+
+}  // namespace intrusive_list
@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "common.h"
+
+namespace intrusive_list {
+
+/**
+ * xor_list_node hook of xor_list.
+ * @link: address of the previous node XOR address of the next node, a
+ * missing neighbour counts as 0
+ */
+struct xor_list_node {
+  uintptr_t link;
+};
+
+/**
+ * xor_list double linked list with one pointer-sized field per node.
+ *
+ * Each hook stores the XOR of its neighbours' addresses, so knowing one
+ * neighbour of a node yields the other. Walking from either end works, and
+ * the ends are plain nullptr so the list can be moved, swapped and reversed
+ * in O(1).
+ *
+ * The price is that a node alone does not reveal its neighbours: there is
+ * no remove_if_exists(), and erase() and insert() need an Iterator, which
+ * carries the previous node along. Unlinking an arbitrary item requires
+ * walking to it first, O(n), unless a neighbour is already known.
+ *
+ * When constant_time_size is true the list keeps an element counter so that
+ * size() is O(1); otherwise size() walks the list.
+ */
+template <typename T, xor_list_node T::*node_field,
+          bool constant_time_size = false>
+class xor_list : private internal::size_counter<constant_time_size> {
+  using Counter = internal::size_counter<constant_time_size>;
+
+  xor_list_node *head_;
+  xor_list_node *tail_;
+
+ public:
+  xor_list() noexcept : head_(nullptr), tail_(nullptr) {}
+
+  xor_list(const xor_list &) = delete;
+  xor_list &operator=(const xor_list &) = delete;
+
+  /**
+   * take over the items of other in O(1), leaving other empty.
+   */
+  xor_list(xor_list &&other) noexcept : xor_list() { swap(other); }
+
+  /**
+   * drop the current items, then take over the items of other in O(1).
+   */
+  xor_list &operator=(xor_list &&other) noexcept {
+    if (&other != this) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * insert item at the front of list.
+   * @param item item to insert in list.
+   */
+  void push_front(T &item) {
+    link_end(get_node(&item), head_, tail_);
+    Counter::size_inc();
+  }
+
+  /**
+   * insert item at the back of list.
+   * @param item item to insert in list.
+   */
+  void push_back(T &item) {
+    link_end(get_node(&item), tail_, head_);
+    Counter::size_inc();
+  }
+
+  /**
+   * remove the first item in the list.
+   */
+  void pop_front() {
+    unlink_end(head_, tail_);
+    Counter::size_dec();
+  }
+
+  /**
+   * remove the last item in the list.
+   */
+  void pop_back() {
+    unlink_end(tail_, head_);
+    Counter::size_dec();
+  }
+
+  /**
+   * return first item in list.
+   * @return first item in list
+   *
+   * Note list need not empty.
+   */
+  T &front() { return *get_owner(head_); }
+
+  /**
+   * return last item in list.
+   * @return last item in list
+   *
+   * Note list need not empty.
+   */
+  T &back() { return *get_owner(tail_); }
+
+  /**
+   * drop all items. Their hooks are left as they are.
+   */
+  void clear() {
+    head_ = tail_ = nullptr;
+    Counter::size_reset();
+  }
+
+  /**
+   * reverse the order of the items in O(1), the links read the same either
+   * way.
+   */
+  void reverse() { std::swap(head_, tail_); }
+
+  bool is_singular() { return head_ && head_ == tail_; }
+
+  /**
+   * check if the list is empty.
+   * @return true if list is empty.
+   */
+  [[nodiscard]] bool empty() const { return head_ == nullptr; }
+
+  /**
+   * return the number of items in the list.
+   * @return number of items in the list
+   *
+   * Note this is O(1) only when constant_time_size is true.
+   */
+  [[nodiscard]] size_t size() const {
+    if constexpr (Counter::enabled) {
+      return Counter::size_get();
+    } else {
+      size_t n = 0;
+      for (auto i = begin(); i != end(); ++i) n++;
+      return n;
+    }
+  }
+
+  /**
+   * position in the list, made of the current node and the node visited
+   * before it. Walking from begin() goes front to back, from rbegin() back
+   * to front.
+   */
+  struct Iterator {
+    Iterator(xor_list_node *p, xor_list_node *v) : prev(p), node(v) {}
+    inline bool operator!=(const Iterator &rhs) const {
+      return node != rhs.node;
+    }
+    inline bool operator==(const Iterator &rhs) const {
+      return node == rhs.node;
+    }
+    T &operator*() const { return *get_owner(node); }
+    T *operator->() const { return get_owner(node); }
+    Iterator &operator++() {
+      xor_list_node *next = neighbour(node, prev);
+      prev = node;
+      node = next;
+      return *this;
+    }
+    xor_list_node *prev;
+    xor_list_node *node;
+  };
+
+  Iterator begin() const { return Iterator{nullptr, head_}; }
+  Iterator end() const { return Iterator{tail_, nullptr}; }
+  Iterator rbegin() const { return Iterator{nullptr, tail_}; }
+  Iterator rend() const { return Iterator{head_, nullptr}; }
+
+  /**
+   * remove the item at position, walking in either direction.
+   * @return iterator to the item after position in the same direction
+   */
+  Iterator erase(Iterator position) {
+    xor_list_node *prev = position.prev;
+    xor_list_node *node = position.node;
+    xor_list_node *next = neighbour(node, prev);
+
+    if (prev) {
+      prev->link ^= address(node) ^ address(next);
+    } else if (head_ == node) {
+      head_ = next;
+    } else {
+      tail_ = next;
+    }
+    if (next) {
+      next->link ^= address(node) ^ address(prev);
+    } else if (tail_ == node) {
+      tail_ = prev;
+    } else {
+      head_ = prev;
+    }
+
+    Counter::size_dec();
+    return Iterator{prev, next};
+  }
+
+  /**
+   * insert item before position.
+   * @param position iterator walking front to back, end() to append
+   * @param item item to insert
+   * @return iterator to item
+   */
+  Iterator insert(Iterator position, T &item) {
+    xor_list_node *prev = position.prev;
+    xor_list_node *next = position.node;
+    xor_list_node *node = get_node(&item);
+
+    node->link = address(prev) ^ address(next);
+    if (prev) {
+      prev->link ^= address(next) ^ address(node);
+    } else {
+      head_ = node;
+    }
+    if (next) {
+      next->link ^= address(prev) ^ address(node);
+    } else {
+      tail_ = node;
+    }
+
+    Counter::size_inc();
+    return Iterator{prev, node};
+  }
+
+  /**
+   * remove the items matching condition.
+   * @return number of removed items
+   */
+  template <typename C>
+  int remove_if(const C &condition) {
+    int removed = 0;
+    for (auto i = begin(); i != end();) {
+      if (condition(*i)) {
+        i = erase(i);
+        removed++;
+      } else {
+        ++i;
+      }
+    }
+    return removed;
+  }
+
+  /**
+   * exchange the items of two lists in O(1).
+   * @param other list to swap with
+   */
+  void swap(xor_list &other) {
+    std::swap(head_, other.head_);
+    std::swap(tail_, other.tail_);
+    std::swap(static_cast<Counter &>(*this), static_cast<Counter &>(other));
+  }
+
+ private:
+  static inline uintptr_t address(xor_list_node *node) {
+    return reinterpret_cast<uintptr_t>(node);
+  }
+
+  static inline xor_list_node *neighbour(xor_list_node *node,
+                                         xor_list_node *other) {
+    return reinterpret_cast<xor_list_node *>(node->link ^ address(other));
+  }
+
+  /**
+   * link node in front of end, the end of the list on that side.
+   */
+  static inline void link_end(xor_list_node *node, xor_list_node *&end,
+                              xor_list_node *&other_end) {
+    node->link = address(end);
+    if (end) {
+      end->link ^= address(node);
+    } else {
+      other_end = node;
+    }
+    end = node;
+  }
+
+  /**
+   * unlink the node at end, the end of the list on that side.
+   */
+  static inline void unlink_end(xor_list_node *&end,
+                                xor_list_node *&other_end) {
+    xor_list_node *node = end;
+    xor_list_node *next = neighbour(node, nullptr);
+    if (next) {
+      next->link ^= address(node);
+    } else {
+      other_end = nullptr;
+    }
+    end = next;
+  }
+
+  static inline constexpr xor_list_node *get_node(T *item) {
+    return &(item->*node_field);
+  }
+
+  static inline constexpr T *get_owner(xor_list_node *member) {
+    return internal::owner_of(member, node_field);
+  }
+};
+
+}  // namespace intrusive_list
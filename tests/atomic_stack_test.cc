@@ -0,0 +1,101 @@
+#include "intrusive_list/atomic_stack.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct stack_test_struct {
+  int value;
+  int owner;
+
+  intrusive_list::forward_list_node node;
+};
+
+using test_stack =
+    intrusive_list::atomic_stack<stack_test_struct, &stack_test_struct::node>;
+
+}  // namespace
+
+TEST(atomic_stack, push_pop) {
+  std::array<stack_test_struct, 10> s{};
+  test_stack stack;
+  ASSERT_TRUE(stack.empty());
+  ASSERT_EQ(stack.pop(), nullptr);
+
+  for (auto& i : s) stack.push(i);
+  ASSERT_FALSE(stack.empty());
+
+  for (auto i = s.rbegin(); i != s.rend(); ++i) ASSERT_EQ(stack.pop(), &*i);
+  ASSERT_EQ(stack.pop(), nullptr);
+  ASSERT_TRUE(stack.empty());
+}
+
+TEST(atomic_stack, push_chain) {
+  std::array<stack_test_struct, 6> s{};
+  test_stack stack;
+  stack.push(s[0]);
+
+  // chain: s[1] -> s[2] -> ... -> s[5]
+  intrusive_list::forward_list<stack_test_struct, &stack_test_struct::node>
+      chain;
+  for (size_t i = s.size() - 1; i > 0; --i) chain.push_front(s[i]);
+  stack.push_chain(chain.front(), s[5]);
+
+  for (size_t i = 1; i < s.size(); ++i) ASSERT_EQ(stack.pop(), &s[i]);
+  ASSERT_EQ(stack.pop(), &s[0]);
+  ASSERT_TRUE(stack.empty());
+}
+
+TEST(atomic_stack, exchange_all) {
+  std::array<stack_test_struct, 4> s{};
+  test_stack stack;
+  ASSERT_TRUE(stack.exchange_all().empty());
+
+  for (auto& i : s) stack.push(i);
+  auto all = stack.exchange_all();
+  ASSERT_TRUE(stack.empty());
+
+  auto i = s.rbegin();
+  for (auto& item : all) ASSERT_EQ(&item, &*i++);
+  ASSERT_EQ(i, s.rend());
+}
+
+TEST(atomic_stack, concurrent_pool) {
+  constexpr int kThreads = 8;
+  constexpr int kRounds = 20000;
+  std::vector<stack_test_struct> s(64);
+  test_stack stack;
+  for (auto& i : s) stack.push(i);
+
+  // every thread keeps taking objects out and giving them back, an object
+  // handed out twice at the same time would be caught by the owner check
+  std::vector<std::thread> threads;
+  std::atomic<int> errors{0};
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int r = 0; r < kRounds; ++r) {
+        auto item = stack.pop();
+        if (!item) continue;
+        item->owner = t;
+        item->value++;
+        if (item->owner != t) errors++;
+        stack.push(*item);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  ASSERT_EQ(errors, 0);
+
+  size_t n = 0;
+  int total = 0;
+  for (auto& item : stack.exchange_all()) {
+    n++;
+    total += item.value;
+  }
+  ASSERT_EQ(n, s.size());
+  ASSERT_GT(total, 0);
+}
@@ -0,0 +1,110 @@
+#include "intrusive_list/buddy_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr size_t kArenaSize = 1 << 20;
+
+struct buddy_arena {
+  alignas(4096) unsigned char bytes[kArenaSize];
+};
+
+}  // namespace
+
+TEST(buddy_allocator, split_and_merge) {
+  auto arena = std::make_unique<buddy_arena>();
+  intrusive_list::buddy_allocator buddy(arena->bytes, kArenaSize, 64);
+  ASSERT_EQ(buddy.free_bytes(), kArenaSize);
+  ASSERT_EQ(buddy.largest_free_block(), kArenaSize);
+  ASSERT_EQ(buddy.fragmentation(), 0);
+
+  // The first allocation splits the arena all the way down.
+  void *a = buddy.allocate(64);
+  ASSERT_EQ(a, arena->bytes);
+  ASSERT_EQ(buddy.free_bytes(), kArenaSize - 64);
+  ASSERT_EQ(buddy.largest_free_block(), kArenaSize / 2);
+  ASSERT_EQ(buddy.free_blocks(64), 1);
+
+  void *b = buddy.allocate(50);
+  ASSERT_EQ(b, arena->bytes + 64);
+  ASSERT_EQ(buddy.free_blocks(64), 0);
+
+  void *c = buddy.allocate(3000);
+  ASSERT_EQ(buddy.block_size_for(3000), 4096);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(c) % 4096, 0);
+  memset(c, 0xcc, 3000);
+
+  buddy.deallocate(a, 64);
+  ASSERT_EQ(buddy.free_blocks(64), 1);
+  ASSERT_GT(buddy.fragmentation(), 0);
+  buddy.deallocate(c, 3000);
+  buddy.deallocate(b, 50);
+  ASSERT_EQ(buddy.free_bytes(), kArenaSize);
+  ASSERT_EQ(buddy.largest_free_block(), kArenaSize);
+  ASSERT_EQ(buddy.free_blocks(kArenaSize), 1);
+
+  buddy.deallocate(nullptr, 64);
+}
+
+TEST(buddy_allocator, uneven_arena) {
+  auto arena = std::make_unique<buddy_arena>();
+  // 768K + 40 bytes: a 512K and a 256K block, the tail is unused.
+  size_t bytes = 3 * kArenaSize / 4 + 40;
+  intrusive_list::buddy_allocator buddy(arena->bytes, bytes, 64);
+  ASSERT_EQ(buddy.free_bytes(), 3 * kArenaSize / 4);
+  ASSERT_EQ(buddy.largest_free_block(), kArenaSize / 2);
+  ASSERT_EQ(buddy.allocate(kArenaSize), nullptr);
+
+  void *big = buddy.allocate(kArenaSize / 2);
+  void *small = buddy.allocate(kArenaSize / 4);
+  ASSERT_NE(big, nullptr);
+  ASSERT_NE(small, nullptr);
+  ASSERT_EQ(buddy.allocate(1), nullptr);
+
+  // The 256K block has no buddy inside the arena and must not merge.
+  buddy.deallocate(small, kArenaSize / 4);
+  buddy.deallocate(big, kArenaSize / 2);
+  ASSERT_EQ(buddy.free_bytes(), 3 * kArenaSize / 4);
+  ASSERT_EQ(buddy.free_blocks(kArenaSize / 2), 1);
+  ASSERT_EQ(buddy.free_blocks(kArenaSize / 4), 1);
+}
+
+TEST(buddy_allocator, random_stress) {
+  auto arena = std::make_unique<buddy_arena>();
+  intrusive_list::buddy_allocator buddy(arena->bytes, kArenaSize, 32);
+
+  std::mt19937 rng(11);
+  std::vector<std::pair<unsigned char *, size_t>> live;
+  for (int round = 0; round < 20000; ++round) {
+    if (live.empty() || rng() % 3 != 0) {
+      size_t size = 1 + rng() % (rng() % 8 == 0 ? 30000 : 500);
+      auto p = static_cast<unsigned char *>(buddy.allocate(size));
+      if (!p) continue;
+      ASSERT_EQ((p - arena->bytes) % buddy.block_size_for(size), 0);
+      memset(p, static_cast<int>(size & 0xff), size);
+      live.emplace_back(p, size);
+    } else {
+      size_t index = rng() % live.size();
+      auto [p, size] = live[index];
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(p[i], static_cast<unsigned char>(size & 0xff));
+      }
+      buddy.deallocate(p, size);
+      live[index] = live.back();
+      live.pop_back();
+    }
+  }
+
+  for (auto [p, size] : live) buddy.deallocate(p, size);
+  ASSERT_EQ(buddy.free_bytes(), kArenaSize);
+  ASSERT_EQ(buddy.largest_free_block(), kArenaSize);
+}
@@ -0,0 +1,164 @@
+#include "intrusive_list/compact.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "intrusive_list/list.h"
+#include "intrusive_list/relative_ptr.h"
+
+namespace {
+
+struct compact_list_node {
+  compact_list_node* next;
+  compact_list_node* prev;
+};
+
+struct compact_test_struct {
+  explicit compact_test_struct(int v) : value(v), text(std::to_string(v)) {}
+
+  // Moving does not touch the hooks, compact() carries them over.
+  compact_test_struct(compact_test_struct&& other) noexcept
+      : value(other.value), text(std::move(other.text)) {}
+
+  int value;
+  std::string text;
+  compact_list_node node{};
+  compact_list_node other_node{};
+  compact_list_node unlinked_node{};
+};
+
+using main_list =
+    intrusive_list::list<compact_test_struct, &compact_test_struct::node, true>;
+using other_list =
+    intrusive_list::list<compact_test_struct, &compact_test_struct::other_node>;
+
+/**
+ * arena handing out consecutive slots.
+ */
+struct compact_arena {
+  struct slot {
+    alignas(compact_test_struct) unsigned char bytes[sizeof(
+        compact_test_struct)];
+  };
+
+  explicit compact_arena(size_t n) : slots(new slot[n]) {}
+
+  ~compact_arena() {
+    for (size_t i = 0; i < used; ++i) {
+      reinterpret_cast<compact_test_struct*>(&slots[i])->~compact_test_struct();
+    }
+  }
+
+  compact_test_struct* relocate(compact_test_struct& old) {
+    auto moved = new (&slots[used++]) compact_test_struct(std::move(old));
+    delete &old;
+    return moved;
+  }
+
+  std::unique_ptr<slot[]> slots;
+  size_t used = 0;
+};
+
+}  // namespace
+
+TEST(compact, relocates_in_traversal_order) {
+  constexpr int kItems = 200;
+  main_list list;
+  other_list odd;
+
+  // Allocate in one order, link in a shuffled order.
+  std::vector<compact_test_struct*> items;
+  for (int i = 0; i < kItems; ++i) items.push_back(new compact_test_struct(i));
+  std::mt19937 rng(3);
+  std::shuffle(items.begin(), items.end(), rng);
+  for (auto item : items) {
+    list.push_back(*item);
+    if (item->value % 2) odd.push_back(*item);
+  }
+  std::vector<int> order;
+  for (auto& item : list) order.push_back(item.value);
+  std::vector<int> odd_order;
+  for (auto& item : odd) odd_order.push_back(item.value);
+
+  compact_arena arena(kItems);
+  size_t moved = intrusive_list::compact<&compact_test_struct::other_node,
+                                         &compact_test_struct::unlinked_node>(
+      list, [&arena](compact_test_struct& old) { return arena.relocate(old); });
+  ASSERT_EQ(moved, kItems);
+  ASSERT_EQ(list.size(), kItems);
+
+  // Same order, now at increasing addresses.
+  std::vector<int> after;
+  const compact_test_struct* last = nullptr;
+  for (auto& item : list) {
+    after.push_back(item.value);
+    ASSERT_EQ(item.text, std::to_string(item.value));
+    ASSERT_GT(&item, last);
+    last = &item;
+  }
+  ASSERT_EQ(after, order);
+
+  // The other list was re-linked too, in both directions.
+  std::vector<int> odd_after;
+  for (auto& item : odd) odd_after.push_back(item.value);
+  ASSERT_EQ(odd_after, odd_order);
+  ASSERT_EQ(odd.back().value, odd_order.back());
+  odd.pop_back();
+  ASSERT_EQ(odd.back().value, odd_order[odd_order.size() - 2]);
+  odd.clear();
+
+  ASSERT_EQ(list.front().unlinked_node.next, nullptr);
+  list.clear();
+}
+
+TEST(compact, keep_in_place) {
+  std::vector<compact_test_struct> items;
+  for (int i = 0; i < 4; ++i) items.emplace_back(i);
+  main_list list;
+  for (auto& item : items) list.push_back(item);
+
+  size_t moved = intrusive_list::compact(
+      list, [](compact_test_struct& old) { return &old; });
+  ASSERT_EQ(moved, 0);
+  ASSERT_EQ(&list.front(), &items[0]);
+  list.clear();
+}
+
+TEST(compact, relative_hooks) {
+  struct relative_compact_struct {
+    int value;
+    intrusive_list::relative_list_node node;
+  };
+  using relative_compact_list =
+      intrusive_list::list<relative_compact_struct,
+                           &relative_compact_struct::node>;
+
+  // Everything in one block so that 32-bit offsets reach.
+  struct block {
+    relative_compact_list list;
+    relative_compact_struct scattered[8];
+    relative_compact_struct packed[8];
+  };
+  auto b = std::make_unique<block>();
+  for (int i = 0; i < 8; ++i) b->scattered[i].value = i;
+  for (int i : {5, 2, 7, 0, 3, 6, 1, 4}) b->list.push_back(b->scattered[i]);
+
+  size_t used = 0;
+  intrusive_list::compact(b->list, [&](relative_compact_struct& old) {
+    b->packed[used].value = old.value;
+    return &b->packed[used++];
+  });
+
+  std::vector<int> values;
+  for (auto& item : b->list) values.push_back(item.value);
+  ASSERT_EQ(values, (std::vector<int>{5, 2, 7, 0, 3, 6, 1, 4}));
+  ASSERT_EQ(&b->list.front(), &b->packed[0]);
+  ASSERT_EQ(&b->list.back(), &b->packed[7]);
+}
@@ -6,7 +6,9 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <list>
+#include <type_traits>
 
 struct list_test_struct {
   int value;
@@ -96,6 +98,25 @@ TEST(forward_list, iterator) {
   ASSERT_EQ(j, list.end());
 }
 
+TEST(forward_list, const_iterator) {
+  std::list<list_test_struct> s(10);
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1> list;
+  for (auto& i : s) list.push_front(i);
+
+  const auto& view = list;
+  static_assert(std::is_same_v<decltype(*view.begin()),
+                               const list_test_struct&>);
+
+  auto i = s.rbegin();
+  for (const auto& item : view) {
+    ASSERT_EQ(&*i, &item);
+    ++i;
+  }
+  ASSERT_EQ(i, s.rend());
+  ASSERT_TRUE(list.cbegin() == view.begin());
+  ASSERT_TRUE(list.cend() == view.end());
+}
+
 TEST(forward_list, remove) {
   std::list<list_test_struct> s(10);
   intrusive_list::forward_list<list_test_struct, &list_test_struct::node1> list;
@@ -116,3 +137,108 @@ TEST(forward_list, remove) {
     return i.value > 4 && i.value < 8;
   }));
 }
+
+TEST(forward_list, size) {
+  std::list<list_test_struct> s(10);
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1> list;
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node2,
+                               true>
+      counted;
+
+  static_assert(sizeof(list) == sizeof(intrusive_list::forward_list_node));
+  ASSERT_EQ(counted.size(), 0);
+
+  int num = 0;
+  for (auto& i : s) {
+    i.value = num++;
+    list.push_front(i);
+    counted.push_front(i);
+  }
+  ASSERT_EQ(list.size(), 10);
+  ASSERT_EQ(counted.size(), 10);
+
+  counted.pop_front();
+  ASSERT_EQ(counted.size(), 9);
+
+  ASSERT_EQ(3, counted.remove_if([](const list_test_struct& i) {
+    return i.value < 3;
+  }));
+  ASSERT_EQ(counted.size(), 6);
+  ASSERT_EQ(list.size(), 10);
+}
+
+TEST(forward_list, sort) {
+  std::array<list_test_struct, 100> s{};
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1>
+      list;
+
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].value = static_cast<int>((i * 37) % 10);
+    list.push_front(s[i]);
+  }
+  list.sort([](const list_test_struct& a, const list_test_struct& b) {
+    return a.value < b.value;
+  });
+
+  // Stable: equal values keep their list order, which is reversed insertion
+  const list_test_struct* prev = nullptr;
+  size_t n = 0;
+  for (auto& i : list) {
+    if (prev) {
+      ASSERT_LE(prev->value, i.value);
+      if (prev->value == i.value) {
+        ASSERT_GT(prev, &i);
+      }
+    }
+    prev = &i;
+    n++;
+  }
+  ASSERT_EQ(n, s.size());
+}
+
+TEST(forward_list, merge_unique) {
+  std::array<list_test_struct, 6> s{};
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1,
+                               true>
+      a;
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1,
+                               true>
+      b;
+
+  int values[] = {5, 3, 1, 4, 3, 0};
+  for (int i = 0; i < 3; ++i) {
+    s[i].value = values[i];
+    a.push_front(s[i]);
+    s[i + 3].value = values[i + 3];
+    b.push_front(s[i + 3]);
+  }
+
+  auto by_value = [](const list_test_struct& x, const list_test_struct& y) {
+    return x.value < y.value;
+  };
+  a.merge(b, by_value);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(a.size(), 6);
+
+  ASSERT_EQ(1, a.unique());
+  ASSERT_EQ(a.size(), 5);
+
+  int expected[] = {0, 1, 3, 4, 5};
+  int n = 0;
+  for (auto& i : a) ASSERT_EQ(i.value, expected[n++]);
+  ASSERT_EQ(n, 5);
+}
+
+TEST(forward_list, reverse) {
+  std::array<list_test_struct, 5> s{};
+  intrusive_list::forward_list<list_test_struct, &list_test_struct::node1> list;
+  list.reverse();
+  ASSERT_TRUE(list.empty());
+
+  for (auto& i : s) list.push_front(i);
+  list.reverse();
+
+  size_t n = 0;
+  for (auto& i : list) ASSERT_EQ(&i, &s[n++]);
+  ASSERT_EQ(n, s.size());
+}
@@ -0,0 +1,146 @@
+#include "intrusive_list/free_list_resource.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/**
+ * upstream that counts what it hands out.
+ */
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  size_t allocations = 0;
+  size_t outstanding = 0;
+
+ protected:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    allocations++;
+    outstanding += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+    outstanding -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+TEST(free_list_resource, reuse_and_stats) {
+  counting_resource upstream;
+  intrusive_list::free_list_resource<> resource(&upstream, 4096);
+
+  void *a = resource.allocate(24);
+  auto stats = resource.stats();
+  ASSERT_EQ(stats.refills, 1);
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.bytes_held, 4096);
+  ASSERT_EQ(upstream.allocations, 1);
+
+  void *b = resource.allocate(32, 16);
+  ASSERT_NE(a, b);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0);
+  ASSERT_EQ(resource.stats().hits, 1);
+
+  resource.deallocate(a, 24);
+  ASSERT_EQ(resource.allocate(20), a);
+  ASSERT_EQ(resource.stats().hits, 2);
+  ASSERT_EQ(upstream.allocations, 1);
+
+  // A different size class needs its own block.
+  void *c = resource.allocate(100);
+  ASSERT_EQ(resource.stats().refills, 2);
+  resource.deallocate(c, 100);
+  resource.deallocate(b, 32, 16);
+  resource.deallocate(a, 20);
+
+  resource.release();
+  ASSERT_EQ(resource.stats().bytes_held, 0);
+  ASSERT_EQ(upstream.outstanding, 0);
+}
+
+TEST(free_list_resource, oversized_and_over_aligned) {
+  counting_resource upstream;
+  intrusive_list::free_list_resource<> resource(&upstream);
+  using resource_type = intrusive_list::free_list_resource<>;
+
+  void *big = resource.allocate(resource_type::max_chunk + 1);
+  ASSERT_EQ(upstream.outstanding, resource_type::max_chunk + 1);
+  void *aligned = resource.allocate(64, 256);
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0);
+  ASSERT_EQ(resource.stats().refills, 0);
+
+  resource.deallocate(big, resource_type::max_chunk + 1);
+  resource.deallocate(aligned, 64, 256);
+  ASSERT_EQ(upstream.outstanding, 0);
+
+  // A request of max_chunk is still pooled, in a block larger than asked.
+  void *largest = resource.allocate(resource_type::max_chunk);
+  ASSERT_EQ(resource.stats().refills, 1);
+  ASSERT_GE(resource.stats().bytes_held, 8 * resource_type::max_chunk);
+  resource.deallocate(largest, resource_type::max_chunk);
+}
+
+TEST(free_list_resource, pmr_containers) {
+  counting_resource upstream;
+  {
+    intrusive_list::free_list_resource<> resource(&upstream);
+    std::pmr::unordered_map<int, std::pmr::string> map(&resource);
+    std::pmr::vector<int> vector(&resource);
+    for (int i = 0; i < 1000; ++i) {
+      map.emplace(i, std::to_string(i) + " long enough to leave the SSO");
+      vector.push_back(i);
+    }
+    for (int i = 0; i < 1000; i += 2) map.erase(i);
+    for (int i = 0; i < 1000; i += 2) map.emplace(i, "again");
+    ASSERT_EQ(map.size(), 1000);
+    ASSERT_EQ(map.at(1), "1 long enough to leave the SSO");
+    ASSERT_EQ(map.at(2), "again");
+    ASSERT_GT(resource.stats().hits, 500);
+  }
+  ASSERT_EQ(upstream.outstanding, 0);
+}
+
+TEST(free_list_resource, thread_safe) {
+  intrusive_list::free_list_resource<true> resource;
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&resource, t] {
+      std::vector<void *> blocks;
+      for (int round = 0; round < 1000; ++round) {
+        for (size_t size = 8; size <= 512; size *= 2) {
+          auto p = static_cast<int *>(resource.allocate(size));
+          *p = t;
+          blocks.push_back(p);
+        }
+        size_t size = 512;
+        while (!blocks.empty()) {
+          auto p = static_cast<int *>(blocks.back());
+          ASSERT_EQ(*p, t);
+          resource.deallocate(p, size);
+          blocks.pop_back();
+          size /= 2;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+
+  auto stats = resource.stats();
+  ASSERT_EQ(stats.hits + stats.refills, 4 * 1000 * 7);
+  ASSERT_LT(stats.refills, 4 * 7 * 2);
+}
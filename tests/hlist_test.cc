@@ -0,0 +1,118 @@
+#include "intrusive_list/hlist.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+namespace {
+
+struct hlist_test_struct {
+  int value;
+  intrusive_list::hlist_node node;
+};
+
+using test_hlist =
+    intrusive_list::hlist<hlist_test_struct, &hlist_test_struct::node>;
+
+std::vector<hlist_test_struct*> items(test_hlist& list) {
+  std::vector<hlist_test_struct*> ret;
+  for (auto& i : list) ret.push_back(&i);
+  return ret;
+}
+
+}  // namespace
+
+TEST(hlist, head_size) {
+  static_assert(sizeof(test_hlist) == sizeof(void*));
+  static_assert(sizeof(intrusive_list::hlist_node) == 2 * sizeof(void*));
+}
+
+TEST(hlist, push_pop) {
+  std::array<hlist_test_struct, 3> s{};
+  test_hlist list;
+  ASSERT_TRUE(list.empty());
+  ASSERT_FALSE(list.is_singular());
+
+  list.push_front(s[0]);
+  ASSERT_TRUE(list.is_singular());
+  list.push_front(s[1]);
+  list.push_front(s[2]);
+  ASSERT_EQ(items(list),
+            std::vector<hlist_test_struct*>({&s[2], &s[1], &s[0]}));
+
+  ASSERT_EQ(&list.front(), &s[2]);
+  list.pop_front();
+  ASSERT_EQ(&list.front(), &s[1]);
+  ASSERT_FALSE(test_hlist::is_linked(s[2]));
+  list.pop_front();
+  list.pop_front();
+  ASSERT_TRUE(list.empty());
+}
+
+TEST(hlist, remove_self) {
+  std::array<hlist_test_struct, 4> s{};
+  test_hlist list;
+  for (auto& i : s) list.push_front(i);
+
+  // middle, last and first, without going through the head
+  ASSERT_TRUE(test_hlist::remove_if_exists(s[2]));
+  ASSERT_FALSE(test_hlist::remove_if_exists(s[2]));
+  ASSERT_TRUE(test_hlist::remove_if_exists(s[0]));
+  ASSERT_TRUE(test_hlist::remove_if_exists(s[3]));
+  ASSERT_EQ(items(list), std::vector<hlist_test_struct*>({&s[1]}));
+  ASSERT_TRUE(test_hlist::remove_if_exists(s[1]));
+  ASSERT_TRUE(list.empty());
+}
+
+TEST(hlist, insert) {
+  std::array<hlist_test_struct, 4> s{};
+  test_hlist list;
+  list.push_front(s[1]);
+  test_hlist::insert_before(s[1], s[0]);
+  test_hlist::insert_after(s[1], s[3]);
+  test_hlist::insert_before(s[3], s[2]);
+  ASSERT_EQ(items(list),
+            std::vector<hlist_test_struct*>({&s[0], &s[1], &s[2], &s[3]}));
+  ASSERT_EQ(&list.front(), &s[0]);
+
+  auto it = list.begin();
+  ++it;
+  it = list.erase(it);
+  ASSERT_EQ(&*it, &s[2]);
+  ASSERT_EQ(items(list),
+            std::vector<hlist_test_struct*>({&s[0], &s[2], &s[3]}));
+}
+
+TEST(hlist, bucket_array) {
+  std::vector<hlist_test_struct> s(100);
+  std::vector<test_hlist> buckets(8);
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].value = static_cast<int>(i);
+    buckets[i % 8].push_front(s[i]);
+  }
+
+  // moving the heads around re-points the first nodes
+  buckets.resize(64);
+  std::swap(buckets[0], buckets[63]);
+  ASSERT_TRUE(buckets[0].empty());
+  for (size_t i = 0; i < s.size(); i += 2) {
+    ASSERT_TRUE(test_hlist::remove_if_exists(s[i]));
+  }
+
+  size_t n = 0;
+  for (auto& bucket : buckets) {
+    for (auto& i : bucket) {
+      ASSERT_EQ(i.value % 2, 1);
+      n++;
+    }
+  }
+  ASSERT_EQ(n, s.size() / 2);
+
+  test_hlist other;
+  other = std::move(buckets[1]);
+  ASSERT_TRUE(buckets[1].empty());
+  ASSERT_FALSE(other.empty());
+  other.clear();
+  ASSERT_FALSE(test_hlist::is_linked(s[1]));
+}
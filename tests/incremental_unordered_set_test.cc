@@ -0,0 +1,104 @@
+#include "intrusive_list/incremental_unordered_set.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+namespace {
+
+struct incremental_test_struct {
+  int key;
+  intrusive_list::forward_list_node node;
+};
+
+struct key_of {
+  int operator()(const incremental_test_struct& item) const {
+    return item.key;
+  }
+};
+
+using test_set = intrusive_list::incremental_unordered_set<
+    incremental_test_struct, &incremental_test_struct::node, key_of>;
+
+}  // namespace
+
+TEST(incremental_unordered_set, insert_find_erase) {
+  std::vector<incremental_test_struct> s(3);
+  test_set set;
+  for (int i = 0; i < 3; ++i) {
+    s[i].key = i;
+    ASSERT_TRUE(set.insert(s[i]));
+  }
+  incremental_test_struct duplicate{1, {}};
+  ASSERT_FALSE(set.insert(duplicate));
+  ASSERT_EQ(set.find(1), &s[1]);
+  ASSERT_EQ(set.erase(1), &s[1]);
+  ASSERT_FALSE(set.erase(s[1]));
+  ASSERT_TRUE(set.erase(s[2]));
+  ASSERT_EQ(set.size(), 1);
+  set.clear();
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(set.find(0), nullptr);
+}
+
+TEST(incremental_unordered_set, incremental_growth) {
+  std::vector<incremental_test_struct> s(20000);
+  test_set set(1024);
+  for (size_t i = 0; i < s.size(); ++i) s[i].key = static_cast<int>(i * 3);
+
+  size_t n = 0;
+  for (; n < 1024; ++n) ASSERT_TRUE(set.insert(s[n]));
+  ASSERT_FALSE(set.rehashing());
+  ASSERT_EQ(set.bucket_count(), 1024);
+
+  // this insert doubles the table but migrates only a few buckets
+  ASSERT_TRUE(set.insert(s[n++]));
+  ASSERT_TRUE(set.rehashing());
+  ASSERT_EQ(set.bucket_count(), 2048);
+
+  // every item stays reachable and visible while the migration runs
+  for (size_t i = 0; i < n; ++i) ASSERT_EQ(set.find(s[i].key), &s[i]);
+  ASSERT_EQ(set.find(1), nullptr);
+  std::set<int> seen;
+  for (auto& i : set) ASSERT_TRUE(seen.insert(i.key).second);
+  ASSERT_EQ(seen.size(), n);
+
+  // erase works on both halves of a migrating table
+  ASSERT_TRUE(set.erase(s[0]));
+  ASSERT_EQ(set.erase(s[n - 1].key), &s[n - 1]);
+  ASSERT_TRUE(set.insert(s[0]));
+  ASSERT_TRUE(set.insert(s[n - 1]));
+
+  for (; n < s.size(); ++n) {
+    ASSERT_TRUE(set.insert(s[n]));
+    ASSERT_LE(set.load_factor(), 1.0f);
+  }
+  for (auto& i : s) ASSERT_EQ(set.find(i.key), &i);
+
+  while (set.rehash_step(1)) {
+  }
+  ASSERT_FALSE(set.rehashing());
+  seen.clear();
+  for (auto& i : set) ASSERT_TRUE(seen.insert(i.key).second);
+  ASSERT_EQ(seen.size(), s.size());
+  ASSERT_EQ(set.size(), s.size());
+}
+
+TEST(incremental_unordered_set, grow_with_erases) {
+  std::vector<incremental_test_struct> s(64);
+  intrusive_list::incremental_unordered_set<
+      incremental_test_struct, &incremental_test_struct::node, key_of,
+      std::hash<int>, std::equal_to<int>, 1>
+      set(1);
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].key = static_cast<int>(i);
+    ASSERT_TRUE(set.insert(s[i]));
+    if (i % 2) {
+      ASSERT_TRUE(set.erase(s[i]));
+      ASSERT_TRUE(set.insert(s[i]));
+    }
+  }
+  for (auto& i : s) ASSERT_EQ(set.find(i.key), &i);
+  ASSERT_EQ(set.size(), s.size());
+}
@@ -0,0 +1,112 @@
+#include "intrusive_list/index_list.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "test_helpers.h"
+
+namespace {
+
+using test_helpers::make_items;
+using test_helpers::values;
+
+struct index_test_struct {
+  int value;
+  intrusive_list::index_list_node<uint16_t> node;
+  intrusive_list::index_list_node<> other_node;
+};
+
+using test_index_list =
+    intrusive_list::index_list<index_test_struct, &index_test_struct::node>;
+using counted_index_list =
+    intrusive_list::index_list<index_test_struct,
+                               &index_test_struct::other_node, true>;
+
+}  // namespace
+
+TEST(index_list, hook_size) {
+  static_assert(sizeof(intrusive_list::index_list_node<uint16_t>) == 4);
+  static_assert(sizeof(intrusive_list::index_list_node<>) == 8);
+}
+
+TEST(index_list, push_pop) {
+  auto items = make_items<index_test_struct>(5);
+  test_index_list list(items.data());
+  ASSERT_TRUE(list.empty());
+  ASSERT_FALSE(list.is_singular());
+
+  list.push_back(items[1]);
+  ASSERT_TRUE(list.is_singular());
+  list.push_back(items[2]);
+  list.push_front(items[0]);
+  list.push_back(items[3]);
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 2, 3}));
+  ASSERT_EQ(list.size(), 4);
+  ASSERT_EQ(list.front().value, 0);
+  ASSERT_EQ(list.back().value, 3);
+
+  list.pop_front();
+  list.pop_back();
+  ASSERT_EQ(values(list), (std::vector<int>{1, 2}));
+  ASSERT_FALSE(test_index_list::is_linked(items[0]));
+  ASSERT_FALSE(test_index_list::is_linked(items[3]));
+
+  list.pop_back();
+  list.pop_front();
+  ASSERT_TRUE(list.empty());
+}
+
+TEST(index_list, remove_and_erase) {
+  auto items = make_items<index_test_struct>(6);
+  counted_index_list list(items.data());
+  for (auto& i : items) list.push_back(i);
+
+  ASSERT_TRUE(list.remove_if_exists(items[0]));
+  ASSERT_TRUE(list.remove_if_exists(items[3]));
+  ASSERT_TRUE(list.remove_if_exists(items[5]));
+  ASSERT_FALSE(list.remove_if_exists(items[3]));
+  ASSERT_EQ(values(list), (std::vector<int>{1, 2, 4}));
+  ASSERT_EQ(list.size(), 3);
+
+  for (auto it = list.begin(); it != list.end();) {
+    if (it->value % 2 == 0) {
+      it = list.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(values(list), (std::vector<int>{1}));
+
+  list.insert(list.begin(), items[0]);
+  list.insert(list.end(), items[5]);
+  auto it = list.begin();
+  ++it;
+  ++it;
+  ASSERT_EQ(list.insert(it, items[3])->value, 3);
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 3, 5}));
+  ASSERT_EQ(list.size(), 4);
+
+  list.clear();
+  ASSERT_TRUE(list.empty());
+  ASSERT_EQ(list.size(), 0);
+  ASSERT_FALSE(list.remove_if_exists(items[1]));
+}
+
+TEST(index_list, two_lists_and_rebase) {
+  auto items = make_items<index_test_struct>(8);
+  test_index_list even(items.data());
+  counted_index_list all(items.data());
+  for (auto& i : items) {
+    if (i.value % 2 == 0) even.push_back(i);
+    all.push_front(i);
+  }
+
+  // Links are indices, so they survive the array being moved.
+  items.reserve(items.capacity() * 4);
+  even.rebase(items.data());
+  all.rebase(items.data());
+  ASSERT_EQ(values(even), (std::vector<int>{0, 2, 4, 6}));
+  ASSERT_EQ(values(all), (std::vector<int>{7, 6, 5, 4, 3, 2, 1, 0}));
+}
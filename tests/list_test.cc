@@ -6,7 +6,10 @@
 
 #include <gtest/gtest.h>
 
+#include <array>
 #include <list>
+#include <type_traits>
+#include <vector>
 
 namespace intrusive_list {
 
@@ -17,6 +20,9 @@ struct list_node {
 
 }  // namespace intrusive_list
 
+// Keep this distinct from the forward_list test struct of the same name
+namespace {
+
 struct list_test_struct {
   int value;
 
@@ -27,6 +33,8 @@ struct list_test_struct {
   bool operator!=(const list_test_struct& rhs) const { return this != &rhs; }
 };
 
+}  // namespace
+
 TEST(list, push_front) {
   std::list<list_test_struct> s(10);
   intrusive_list::list<list_test_struct, &list_test_struct::node1> list;
@@ -147,3 +155,349 @@ TEST(list, iterator) {
     }
   }
 }
+
+TEST(list, const_iterator) {
+  std::list<list_test_struct> s(10);
+  intrusive_list::list<list_test_struct, &list_test_struct::node1> list;
+  for (auto& i : s) list.push_back(i);
+
+  const auto& view = list;
+  static_assert(std::is_same_v<decltype(*view.begin()),
+                               const list_test_struct&>);
+  static_assert(std::is_same_v<decltype(*list.cbegin()),
+                               const list_test_struct&>);
+
+  auto i = s.begin();
+  for (const auto& item : view) {
+    ASSERT_EQ(&*i, &item);
+    ++i;
+  }
+  ASSERT_EQ(i, s.end());
+
+  decltype(list.cbegin()) second = ++list.begin();
+  ASSERT_EQ(&*second, &*++s.begin());
+  ASSERT_TRUE(list.cend() == view.end());
+}
+
+TEST(list, size) {
+  std::array<list_test_struct, 5> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1> list;
+  intrusive_list::list<list_test_struct, &list_test_struct::node2, true>
+      counted;
+
+  static_assert(sizeof(list) == sizeof(intrusive_list::list_node));
+  ASSERT_EQ(list.size(), 0);
+  ASSERT_EQ(counted.size(), 0);
+
+  for (auto& i : s) {
+    list.push_back(i);
+    counted.push_front(i);
+  }
+  ASSERT_EQ(list.size(), 5);
+  ASSERT_EQ(counted.size(), 5);
+
+  counted.pop_front();
+  counted.pop_back();
+  ASSERT_EQ(counted.size(), 3);
+
+  ASSERT_TRUE(counted.remove_if_exists(s[2]));
+  ASSERT_FALSE(counted.remove_if_exists(s[2]));
+  ASSERT_EQ(counted.size(), 2);
+
+  counted.erase(counted.begin());
+  ASSERT_EQ(counted.size(), 1);
+  list.erase(list.begin());
+  ASSERT_EQ(list.size(), 4);
+}
+
+TEST(list, remove_if_exists_counted) {
+  std::array<list_test_struct, 4> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> a;
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> b;
+  a.push_back(s[0]);
+  a.push_back(s[1]);
+  b.push_back(s[2]);
+
+  // Unlinked items leave the counter alone.
+  ASSERT_FALSE(a.remove_if_exists(s[3]));
+  ASSERT_EQ(a.size(), 2);
+
+  ASSERT_TRUE(a.remove_if_exists(s[1]));
+  ASSERT_FALSE(a.remove_if_exists(s[1]));
+  ASSERT_EQ(a.size(), 1);
+  ASSERT_EQ(&a.back(), &s[0]);
+
+  ASSERT_TRUE(b.remove_if_exists(s[2]));
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(b.size(), 0);
+
+  // A removed item can be linked again and counted again.
+  a.push_front(s[1]);
+  ASSERT_EQ(a.size(), 2);
+  ASSERT_TRUE(a.remove_if_exists(s[0]));
+  ASSERT_TRUE(a.remove_if_exists(s[1]));
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(a.size(), 0);
+}
+
+TEST(list, sort) {
+  std::vector<list_test_struct> s(100);
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> list;
+  auto by_value = [](const list_test_struct& a, const list_test_struct& b) {
+    return a.value < b.value;
+  };
+
+  list.sort(by_value);
+  ASSERT_TRUE(list.empty());
+
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].value = static_cast<int>((i * 37) % 10);
+    list.push_back(s[i]);
+  }
+  list.sort(by_value);
+  ASSERT_EQ(list.size(), s.size());
+
+  // Stable: equal values keep their insertion (address) order
+  const list_test_struct* prev = nullptr;
+  for (auto& i : list) {
+    if (prev) {
+      ASSERT_LE(prev->value, i.value);
+      if (prev->value == i.value) {
+        ASSERT_LT(prev, &i);
+      }
+    }
+    prev = &i;
+  }
+  ASSERT_EQ(&list.back(), prev);
+
+  // prev pointers are rebuilt as well
+  int last = list.back().value;
+  while (!list.empty()) {
+    ASSERT_LE(list.back().value, last);
+    last = list.back().value;
+    list.pop_back();
+  }
+}
+
+TEST(list, merge) {
+  std::array<list_test_struct, 10> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> a;
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> b;
+  auto by_value = [](const list_test_struct& x, const list_test_struct& y) {
+    return x.value < y.value;
+  };
+
+  for (int i = 0; i < 5; ++i) {
+    s[i].value = i * 2;
+    a.push_back(s[i]);
+    s[i + 5].value = i * 2 + 1;
+    b.push_back(s[i + 5]);
+  }
+  s[9].value = 8;  // tie with s[4], which must stay first
+
+  a.merge(b, by_value);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(b.size(), 0);
+  ASSERT_EQ(a.size(), 10);
+
+  std::vector<list_test_struct*> order;
+  for (auto& i : a) order.push_back(&i);
+  ASSERT_EQ(order.size(), 10);
+  for (size_t i = 1; i < order.size(); ++i) {
+    ASSERT_LE(order[i - 1]->value, order[i]->value);
+  }
+  ASSERT_EQ(order[8], &s[4]);
+  ASSERT_EQ(order[9], &s[9]);
+
+  b.merge(a, by_value);
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(b.size(), 10);
+  ASSERT_EQ(&b.front(), order.front());
+  ASSERT_EQ(&b.back(), order.back());
+}
+
+TEST(list, unique) {
+  std::array<list_test_struct, 8> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> list;
+  int values[] = {1, 1, 2, 3, 3, 3, 1, 4};
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].value = values[i];
+    list.push_back(s[i]);
+  }
+
+  ASSERT_EQ(3, list.unique([](const list_test_struct& a,
+                              const list_test_struct& b) {
+    return a.value == b.value;
+  }));
+  ASSERT_EQ(list.size(), 5);
+  ASSERT_FALSE(list.remove_if_exists(s[1]));
+
+  int expected[] = {1, 2, 3, 1, 4};
+  int n = 0;
+  for (auto& i : list) ASSERT_EQ(i.value, expected[n++]);
+  ASSERT_EQ(n, 5);
+}
+
+TEST(list, splice) {
+  std::array<list_test_struct, 6> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> a;
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> b;
+  for (int i = 0; i < 3; ++i) {
+    s[i].value = i;
+    a.push_back(s[i]);
+    s[i + 3].value = i + 3;
+    b.push_back(s[i + 3]);
+  }
+
+  // a: 0 3 4 5 1 2
+  a.splice(++a.begin(), b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(b.size(), 0);
+  ASSERT_EQ(a.size(), 6);
+  int expected[] = {0, 3, 4, 5, 1, 2};
+  int n = 0;
+  for (auto& i : a) ASSERT_EQ(i.value, expected[n++]);
+
+  // b: 3 4, a: 0 5 1 2
+  auto first = ++a.begin();
+  auto last = first;
+  ++last;
+  ++last;
+  b.splice(b.end(), a, first, last);
+  ASSERT_EQ(a.size(), 4);
+  ASSERT_EQ(b.size(), 2);
+  ASSERT_EQ(b.front(), s[3]);
+  ASSERT_EQ(b.back(), s[4]);
+
+  // within one list, a: 1 2 0 5
+  a.splice(a.begin(), a, ++(++a.begin()), a.end());
+  ASSERT_EQ(a.size(), 4);
+  int expected2[] = {1, 2, 0, 5};
+  n = 0;
+  for (auto& i : a) ASSERT_EQ(i.value, expected2[n++]);
+  ASSERT_EQ(a.back(), s[5]);
+}
+
+TEST(list, split_at) {
+  std::array<list_test_struct, 5> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> a;
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> b;
+  for (auto& i : s) a.push_back(i);
+
+  auto position = a.begin();
+  ++position;
+  ++position;
+  a.split_at(position, b);
+  ASSERT_EQ(a.size(), 2);
+  ASSERT_EQ(b.size(), 3);
+  ASSERT_EQ(a.back(), s[1]);
+  ASSERT_EQ(b.front(), s[2]);
+  ASSERT_EQ(b.back(), s[4]);
+
+  a.split_at(a.end(), b);
+  ASSERT_EQ(a.size(), 2);
+
+  b.split_at(b.begin(), a);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(a.size(), 5);
+  ASSERT_EQ(a.back(), s[4]);
+}
+
+TEST(list, swap) {
+  std::array<list_test_struct, 4> s{};
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> a;
+  intrusive_list::list<list_test_struct, &list_test_struct::node1, true> b;
+  a.push_back(s[0]);
+  a.push_back(s[1]);
+  a.push_back(s[2]);
+  b.push_back(s[3]);
+
+  a.swap(b);
+  ASSERT_EQ(a.size(), 1);
+  ASSERT_EQ(b.size(), 3);
+  ASSERT_EQ(a.front(), s[3]);
+  ASSERT_EQ(a.back(), s[3]);
+  ASSERT_EQ(b.front(), s[0]);
+  ASSERT_EQ(b.back(), s[2]);
+
+  a.pop_back();
+  a.swap(b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(a.size(), 3);
+  ASSERT_EQ(a.back(), s[2]);
+  a.pop_back();
+  ASSERT_EQ(a.back(), s[1]);
+
+  b.swap(a);
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(b.size(), 2);
+  b.push_front(s[3]);
+  ASSERT_EQ(b.front(), s[3]);
+  a.push_back(s[2]);
+  ASSERT_EQ(a.front(), s[2]);
+}
+
+namespace {
+
+using counted_list =
+    intrusive_list::list<list_test_struct, &list_test_struct::node1, true>;
+
+counted_list make_list(list_test_struct* first, size_t n) {
+  counted_list list;
+  for (size_t i = 0; i < n; ++i) list.push_back(first[i]);
+  return list;
+}
+
+}  // namespace
+
+TEST(list, move) {
+  std::array<list_test_struct, 6> s{};
+
+  counted_list a = make_list(s.data(), 3);
+  ASSERT_EQ(a.size(), 3);
+  ASSERT_EQ(a.front(), s[0]);
+  ASSERT_EQ(a.back(), s[2]);
+
+  counted_list b(std::move(a));
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(a.size(), 0);
+  ASSERT_EQ(b.size(), 3);
+  b.pop_back();
+  ASSERT_EQ(b.back(), s[1]);
+  b.push_back(s[2]);
+
+  counted_list empty;
+  counted_list c(std::move(empty));
+  ASSERT_TRUE(c.empty());
+  c.push_back(s[3]);
+  ASSERT_EQ(c.front(), s[3]);
+
+  // the previous items of the target are unlinked
+  c = std::move(b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(c.size(), 3);
+  ASSERT_FALSE(c.remove_if_exists(s[3]));
+  ASSERT_EQ(c.front(), s[0]);
+  ASSERT_EQ(c.back(), s[2]);
+}
+
+TEST(list, vector_of_lists) {
+  std::vector<list_test_struct> s(40);
+  std::vector<counted_list> lists;
+  for (size_t i = 0; i < 10; ++i) {
+    lists.push_back(make_list(&s[i * 4], 4));
+  }
+
+  for (size_t i = 0; i < lists.size(); ++i) {
+    auto& list = lists[i];
+    ASSERT_EQ(list.size(), 4);
+    ASSERT_EQ(list.front(), s[i * 4]);
+    ASSERT_EQ(list.back(), s[i * 4 + 3]);
+    size_t n = 0;
+    for (auto& item : list) ASSERT_EQ(item, s[i * 4 + n++]);
+    ASSERT_EQ(n, 4);
+    list.pop_front();
+    list.pop_back();
+    ASSERT_EQ(list.size(), 2);
+  }
+}
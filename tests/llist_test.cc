@@ -0,0 +1,95 @@
+#include "intrusive_list/llist.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct llist_test_struct {
+  int producer;
+  int sequence;
+
+  intrusive_list::forward_list_node node;
+};
+
+using test_llist =
+    intrusive_list::llist<llist_test_struct, &llist_test_struct::node>;
+
+}  // namespace
+
+TEST(llist, add_del_all) {
+  std::array<llist_test_struct, 5> s{};
+  test_llist list;
+  ASSERT_TRUE(list.empty());
+  ASSERT_TRUE(list.del_all().empty());
+
+  ASSERT_TRUE(list.add(s[0]));
+  for (size_t i = 1; i < s.size(); ++i) ASSERT_FALSE(list.add(s[i]));
+
+  auto all = list.del_all();
+  ASSERT_TRUE(list.empty());
+  auto i = s.rbegin();
+  for (auto& item : all) ASSERT_EQ(&item, &*i++);
+  ASSERT_EQ(i, s.rend());
+
+  all.reverse();
+  size_t n = 0;
+  for (auto& item : all) ASSERT_EQ(&item, &s[n++]);
+  ASSERT_EQ(n, s.size());
+}
+
+TEST(llist, add_batch) {
+  std::array<llist_test_struct, 4> s{};
+  test_llist list;
+  list.add(s[0]);
+
+  intrusive_list::forward_list<llist_test_struct, &llist_test_struct::node>
+      batch;
+  batch.push_front(s[3]);
+  batch.push_front(s[2]);
+  batch.push_front(s[1]);
+  ASSERT_FALSE(list.add_batch(batch.front(), s[3]));
+
+  auto all = list.del_all();
+  size_t n = 0;
+  for (auto& item : all) ASSERT_EQ(&item, &s[++n % 4]);
+  ASSERT_EQ(n, 4);
+}
+
+TEST(llist, multi_producer) {
+  constexpr int kProducers = 8;
+  constexpr int kItems = 20000;
+  std::vector<llist_test_struct> s(kProducers * kItems);
+  test_llist list;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kItems; ++i) {
+        auto& item = s[p * kItems + i];
+        item.producer = p;
+        item.sequence = i;
+        list.add(item);
+      }
+    });
+  }
+
+  // after reverse() every detached batch is in per producer FIFO order,
+  // EXPECT while the producers are still joinable
+  std::array<int, kProducers> next{};
+  int received = 0;
+  while (received < kProducers * kItems) {
+    auto batch = list.del_all();
+    batch.reverse();
+    for (auto& item : batch) {
+      EXPECT_EQ(item.sequence, next[item.producer]++);
+      received++;
+    }
+  }
+
+  for (auto& t : producers) t.join();
+  ASSERT_TRUE(list.empty());
+}
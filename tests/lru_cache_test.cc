@@ -0,0 +1,141 @@
+#include "intrusive_list/lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "intrusive_list/forward_list.h"
+
+namespace {
+
+struct lru_node {
+  lru_node* next;
+  lru_node* prev;
+};
+
+struct lru_test_struct {
+  int key;
+  lru_node node;
+  intrusive_list::forward_list_node index_node;
+};
+
+struct key_of {
+  int operator()(const lru_test_struct& item) const { return item.key; }
+};
+
+struct record_evict {
+  std::vector<int>* evicted;
+  void operator()(lru_test_struct& item) const {
+    evicted->push_back(item.key);
+  }
+};
+
+using test_cache =
+    intrusive_list::lru_cache<lru_test_struct, &lru_test_struct::node,
+                              &lru_test_struct::index_node, key_of,
+                              record_evict>;
+
+}  // namespace
+
+TEST(lru_cache, insert_find) {
+  std::array<lru_test_struct, 3> s{};
+  std::vector<int> evicted;
+  test_cache cache(3, record_evict{&evicted});
+  for (int i = 0; i < 3; ++i) {
+    s[i].key = i;
+    ASSERT_TRUE(cache.insert(s[i]));
+  }
+  ASSERT_EQ(cache.size(), 3);
+  ASSERT_EQ(cache.find(1), &s[1]);
+  ASSERT_EQ(cache.find(7), nullptr);
+  ASSERT_EQ(&cache.mru(), &s[1]);
+  ASSERT_EQ(&cache.lru(), &s[0]);
+
+  // peek does not promote
+  ASSERT_EQ(cache.peek(0), &s[0]);
+  ASSERT_EQ(&cache.lru(), &s[0]);
+
+  // duplicate keys are rejected
+  lru_test_struct duplicate{1, {}, {}};
+  ASSERT_FALSE(cache.insert(duplicate));
+  ASSERT_EQ(cache.size(), 3);
+  ASSERT_TRUE(evicted.empty());
+}
+
+TEST(lru_cache, evict) {
+  std::array<lru_test_struct, 6> s{};
+  std::vector<int> evicted;
+  test_cache cache(3, record_evict{&evicted});
+  for (int i = 0; i < 6; ++i) s[i].key = i;
+
+  cache.insert(s[0]);
+  cache.insert(s[1]);
+  cache.insert(s[2]);
+  cache.touch(s[0]);  // order: 0 2 1
+  cache.insert(s[3]);  // evicts 1
+  ASSERT_EQ(evicted, std::vector<int>({1}));
+  ASSERT_EQ(cache.find(1), nullptr);
+  ASSERT_EQ(cache.size(), 3);
+
+  ASSERT_EQ(cache.find(2), &s[2]);  // order: 2 3 0
+  cache.insert(s[4]);               // evicts 0
+  ASSERT_EQ(evicted, std::vector<int>({1, 0}));
+
+  int expected[] = {4, 2, 3};
+  int n = 0;
+  for (auto& i : cache) ASSERT_EQ(i.key, expected[n++]);
+  ASSERT_EQ(n, 3);
+
+  ASSERT_EQ(cache.evict_one(), &s[3]);
+  cache.set_capacity(1);
+  ASSERT_EQ(evicted, std::vector<int>({1, 0, 3, 2}));
+  ASSERT_EQ(cache.size(), 1);
+  ASSERT_EQ(&cache.lru(), &s[4]);
+
+  // an evicted item may be inserted again
+  ASSERT_TRUE(cache.insert(s[1]));
+  ASSERT_EQ(evicted.back(), 4);
+}
+
+TEST(lru_cache, erase) {
+  std::array<lru_test_struct, 3> s{};
+  std::vector<int> evicted;
+  test_cache cache(3, record_evict{&evicted});
+  for (int i = 0; i < 3; ++i) {
+    s[i].key = i;
+    cache.insert(s[i]);
+  }
+
+  ASSERT_EQ(cache.erase(1), &s[1]);
+  ASSERT_EQ(cache.erase(1), nullptr);
+  cache.erase(s[0]);
+  ASSERT_EQ(cache.size(), 1);
+  ASSERT_EQ(cache.find(0), nullptr);
+  ASSERT_TRUE(evicted.empty());
+
+  ASSERT_EQ(cache.evict_one(), &s[2]);
+  ASSERT_EQ(cache.evict_one(), nullptr);
+  ASSERT_TRUE(cache.empty());
+}
+
+TEST(lru_cache, churn) {
+  std::vector<lru_test_struct> s(300);
+  std::vector<int> evicted;
+  test_cache cache(100, record_evict{&evicted});
+  for (int i = 0; i < 300; ++i) {
+    s[i].key = i;
+    ASSERT_TRUE(cache.insert(s[i]));
+  }
+  ASSERT_EQ(cache.size(), 100);
+  ASSERT_EQ(evicted.size(), 200);
+  for (int i = 0; i < 200; ++i) ASSERT_EQ(cache.peek(i), nullptr);
+  for (int i = 200; i < 300; ++i) ASSERT_EQ(cache.peek(i), &s[i]);
+
+  // growing the index keeps every cached item reachable
+  cache.set_capacity(250);
+  for (int i = 0; i < 150; ++i) ASSERT_TRUE(cache.insert(s[i]));
+  ASSERT_EQ(cache.size(), 250);
+  ASSERT_EQ(evicted.size(), 200);
+  for (auto& i : cache) ASSERT_EQ(cache.peek(i.key), &i);
+}
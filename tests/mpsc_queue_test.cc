@@ -0,0 +1,101 @@
+#include "intrusive_list/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct mpsc_test_struct {
+  int producer;
+  int sequence;
+
+  intrusive_list::forward_list_node node;
+};
+
+using test_queue =
+    intrusive_list::mpsc_queue<mpsc_test_struct, &mpsc_test_struct::node>;
+
+}  // namespace
+
+TEST(mpsc_queue, push_pop) {
+  std::array<mpsc_test_struct, 10> s{};
+  test_queue queue;
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(queue.pop(), nullptr);
+
+  for (auto& i : s) queue.push(i);
+  ASSERT_FALSE(queue.empty());
+
+  for (auto& i : s) ASSERT_EQ(queue.pop(), &i);
+  ASSERT_EQ(queue.pop(), nullptr);
+  ASSERT_TRUE(queue.empty());
+
+  // reuse after draining, including the stub re-insertion path
+  queue.push(s[0]);
+  ASSERT_EQ(queue.pop(), &s[0]);
+  queue.push(s[1]);
+  queue.push(s[2]);
+  ASSERT_EQ(queue.pop(), &s[1]);
+  queue.push(s[3]);
+  ASSERT_EQ(queue.pop(), &s[2]);
+  ASSERT_EQ(queue.pop(), &s[3]);
+  ASSERT_TRUE(queue.empty());
+}
+
+TEST(mpsc_queue, pop_all) {
+  std::array<mpsc_test_struct, 5> s{};
+  test_queue queue;
+  for (auto& i : s) queue.push(i);
+
+  auto batch = queue.pop_all();
+  ASSERT_TRUE(queue.empty());
+  size_t n = 0;
+  for (auto& i : batch) ASSERT_EQ(&i, &s[n++]);
+  ASSERT_EQ(n, s.size());
+
+  // items may be pushed again while the batch is being processed
+  while (!batch.empty()) {
+    auto& item = batch.front();
+    batch.pop_front();
+    queue.push(item);
+  }
+  ASSERT_EQ(queue.pop(), &s[0]);
+}
+
+TEST(mpsc_queue, multi_producer) {
+  constexpr int kProducers = 8;
+  constexpr int kItems = 20000;
+  std::vector<mpsc_test_struct> s(kProducers * kItems);
+  test_queue queue;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      for (int i = 0; i < kItems; ++i) {
+        auto& item = s[p * kItems + i];
+        item.producer = p;
+        item.sequence = i;
+        queue.push(item);
+      }
+    });
+  }
+
+  // per producer FIFO order must be preserved, EXPECT so that a failure
+  // does not return with the producers still joinable
+  std::array<int, kProducers> next{};
+  int received = 0;
+  while (received < kProducers * kItems) {
+    auto batch = queue.pop_all();
+    for (auto& item : batch) {
+      EXPECT_EQ(item.sequence, next[item.producer]++);
+      received++;
+    }
+  }
+
+  for (auto& t : producers) t.join();
+  ASSERT_EQ(queue.pop(), nullptr);
+  ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,84 @@
+#include "intrusive_list/object_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct pool_test_object {
+  static int live;
+
+  explicit pool_test_object(int v) : value(v) {
+    if (v < 0) throw std::invalid_argument("negative");
+    live++;
+  }
+  ~pool_test_object() { live--; }
+
+  int value;
+  char padding[20];
+};
+
+int pool_test_object::live = 0;
+
+struct alignas(64) aligned_object {
+  int value;
+};
+
+}  // namespace
+
+TEST(object_pool, allocate_deallocate) {
+  intrusive_list::object_pool<pool_test_object> pool(4);
+  ASSERT_EQ(pool.capacity(), 0);
+
+  std::set<pool_test_object*> seen;
+  std::vector<pool_test_object*> objects;
+  for (int i = 0; i < 10; ++i) {
+    auto p = pool.allocate();
+    ASSERT_TRUE(seen.insert(p).second);
+    objects.push_back(p);
+  }
+  ASSERT_EQ(pool.capacity(), 12);
+  ASSERT_EQ(pool.available(), 2);
+
+  // slots of one slab are handed out in address order
+  ASSERT_EQ(objects[1], objects[0] + 1);
+
+  for (auto p : objects) pool.deallocate(p);
+  ASSERT_EQ(pool.available(), 12);
+
+  // freed slots are reused first, and no new slab is requested
+  for (int i = 0; i < 10; ++i) ASSERT_EQ(seen.count(pool.allocate()), 1);
+  pool.allocate();
+  pool.allocate();
+  ASSERT_EQ(pool.capacity(), 12);
+  ASSERT_EQ(pool.available(), 0);
+}
+
+TEST(object_pool, create_destroy) {
+  intrusive_list::object_pool<pool_test_object> pool;
+  auto a = pool.create(1);
+  auto b = pool.create(2);
+  ASSERT_EQ(a->value, 1);
+  ASSERT_EQ(b->value, 2);
+  ASSERT_EQ(pool_test_object::live, 2);
+
+  size_t available = pool.available();
+  ASSERT_THROW(pool.create(-1), std::invalid_argument);
+  ASSERT_EQ(pool.available(), available);
+
+  pool.destroy(a);
+  pool.destroy(b);
+  ASSERT_EQ(pool_test_object::live, 0);
+}
+
+TEST(object_pool, alignment) {
+  intrusive_list::object_pool<aligned_object> pool(3);
+  for (int i = 0; i < 10; ++i) {
+    auto p = pool.create();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(aligned_object), 0);
+  }
+}
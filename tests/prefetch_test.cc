@@ -0,0 +1,78 @@
+#include "intrusive_list/prefetch.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+#include "intrusive_list/forward_list.h"
+#include "intrusive_list/hlist.h"
+#include "intrusive_list/list.h"
+#include "intrusive_list/xor_list.h"
+
+namespace {
+
+struct prefetch_list_node {
+  prefetch_list_node *next;
+  prefetch_list_node *prev;
+};
+
+struct prefetch_test_struct {
+  int value;
+  prefetch_list_node node;
+  intrusive_list::forward_list_node forward_node;
+  intrusive_list::hlist_node hnode;
+  intrusive_list::xor_list_node xnode;
+};
+
+template <typename Container>
+std::vector<int> visit(Container& container, size_t distance) {
+  std::vector<int> ret;
+  intrusive_list::for_each_prefetch(
+      container, distance,
+      [&ret](prefetch_test_struct& i) { ret.push_back(i.value); });
+  return ret;
+}
+
+}  // namespace
+
+TEST(prefetch, visits_in_order) {
+  std::array<prefetch_test_struct, 20> items{};
+  intrusive_list::list<prefetch_test_struct, &prefetch_test_struct::node> list;
+  intrusive_list::forward_list<prefetch_test_struct,
+                               &prefetch_test_struct::forward_node>
+      forward_list;
+  intrusive_list::hlist<prefetch_test_struct, &prefetch_test_struct::hnode>
+      hlist;
+  intrusive_list::xor_list<prefetch_test_struct, &prefetch_test_struct::xnode>
+      xor_list;
+
+  std::vector<int> expected, reversed;
+  for (int i = 0; i < 20; ++i) {
+    items[i].value = i;
+    list.push_back(items[i]);
+    forward_list.push_front(items[i]);
+    hlist.push_front(items[i]);
+    xor_list.push_back(items[i]);
+    expected.push_back(i);
+    reversed.insert(reversed.begin(), i);
+  }
+
+  for (size_t distance : {0, 1, 4, 19, 20, 100}) {
+    ASSERT_EQ(visit(list, distance), expected);
+    ASSERT_EQ(visit(forward_list, distance), reversed);
+    ASSERT_EQ(visit(hlist, distance), reversed);
+    ASSERT_EQ(visit(xor_list, distance), expected);
+  }
+}
+
+TEST(prefetch, empty_and_mutating) {
+  std::array<prefetch_test_struct, 3> items{};
+  intrusive_list::list<prefetch_test_struct, &prefetch_test_struct::node> list;
+  ASSERT_TRUE(visit(list, 8).empty());
+
+  for (auto& i : items) list.push_back(i);
+  intrusive_list::for_each_prefetch(
+      list, 2, [](prefetch_test_struct& i) { i.value = 7; });
+  for (auto& i : items) ASSERT_EQ(i.value, 7);
+}
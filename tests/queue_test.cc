@@ -0,0 +1,158 @@
+#include "intrusive_list/queue.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <type_traits>
+
+#include "intrusive_list/relative_ptr.h"
+
+namespace {
+
+struct queue_test_struct {
+  int value;
+
+  intrusive_list::forward_list_node node1;
+  intrusive_list::forward_list_node node2;
+};
+
+using test_queue =
+    intrusive_list::queue<queue_test_struct, &queue_test_struct::node1>;
+using counted_queue =
+    intrusive_list::queue<queue_test_struct, &queue_test_struct::node1, true>;
+
+}  // namespace
+
+TEST(queue, push_pop) {
+  std::array<queue_test_struct, 10> s{};
+  test_queue queue;
+  ASSERT_TRUE(queue.empty());
+
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].value = static_cast<int>(i);
+    queue.push_back(s[i]);
+    ASSERT_EQ(&queue.back(), &s[i]);
+  }
+  ASSERT_EQ(queue.size(), s.size());
+
+  for (auto& i : s) {
+    ASSERT_FALSE(queue.empty());
+    ASSERT_EQ(&queue.front(), &i);
+    queue.pop_front();
+  }
+  ASSERT_TRUE(queue.empty());
+
+  // the tail is reset once the queue drains
+  queue.push_back(s[3]);
+  ASSERT_EQ(&queue.front(), &s[3]);
+  ASSERT_EQ(&queue.back(), &s[3]);
+}
+
+TEST(queue, push_front) {
+  std::array<queue_test_struct, 3> s{};
+  test_queue queue;
+
+  queue.push_front(s[1]);
+  ASSERT_TRUE(queue.is_singular());
+  ASSERT_EQ(&queue.back(), &s[1]);
+  queue.push_front(s[0]);
+  queue.push_back(s[2]);
+  ASSERT_FALSE(queue.is_singular());
+
+  size_t n = 0;
+  for (auto& i : queue) ASSERT_EQ(&i, &s[n++]);
+  ASSERT_EQ(n, 3);
+}
+
+TEST(queue, append) {
+  std::array<queue_test_struct, 6> s{};
+  counted_queue a;
+  counted_queue b;
+  for (int i = 0; i < 3; ++i) {
+    a.push_back(s[i]);
+    b.push_back(s[i + 3]);
+  }
+
+  a.append(b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(b.size(), 0);
+  ASSERT_EQ(a.size(), 6);
+  ASSERT_EQ(&a.back(), &s[5]);
+
+  size_t n = 0;
+  for (auto& i : a) ASSERT_EQ(&i, &s[n++]);
+  ASSERT_EQ(n, 6);
+
+  // appending an empty queue, and appending into an empty queue
+  a.append(b);
+  ASSERT_EQ(a.size(), 6);
+  b.append(a);
+  ASSERT_EQ(b.size(), 6);
+  ASSERT_EQ(&b.front(), &s[0]);
+  ASSERT_EQ(&b.back(), &s[5]);
+}
+
+TEST(queue, take_all) {
+  std::array<queue_test_struct, 6> s{};
+  counted_queue queue;
+  for (int i = 0; i < 4; ++i) queue.push_back(s[i]);
+
+  counted_queue all = queue.take_all();
+  ASSERT_TRUE(queue.empty());
+  ASSERT_EQ(all.size(), 4);
+  ASSERT_EQ(&all.front(), &s[0]);
+  ASSERT_EQ(&all.back(), &s[3]);
+
+  queue.push_back(s[4]);
+  ASSERT_EQ(&queue.back(), &s[4]);
+
+  counted_queue moved(std::move(all));
+  ASSERT_TRUE(all.empty());
+  ASSERT_EQ(moved.size(), 4);
+  moved.push_back(s[5]);
+  ASSERT_EQ(&moved.back(), &s[5]);
+  ASSERT_EQ(moved.size(), 5);
+}
+
+TEST(queue, const_iterator) {
+  std::array<queue_test_struct, 5> s{};
+  test_queue queue;
+  for (auto& i : s) queue.push_back(i);
+
+  const auto& view = queue;
+  static_assert(std::is_same_v<decltype(*view.begin()),
+                               const queue_test_struct&>);
+  size_t n = 0;
+  for (const auto& item : view) ASSERT_EQ(&item, &s[n++]);
+  ASSERT_EQ(n, s.size());
+  ASSERT_TRUE(queue.cbegin() == view.begin());
+  ASSERT_TRUE(queue.cend() == view.end());
+}
+
+TEST(queue, relative_hook) {
+  struct relative_item {
+    int value;
+    intrusive_list::relative_forward_list_node node;
+  };
+  // The queue sits next to its items, well within 32-bit offsets.
+  struct arena {
+    intrusive_list::queue<relative_item, &relative_item::node, true> queue;
+    std::array<relative_item, 4> items;
+  } a{};
+
+  for (int i = 0; i < 4; ++i) {
+    a.items[i].value = i;
+    a.queue.push_back(a.items[i]);
+  }
+  ASSERT_EQ(&a.queue.back(), &a.items[3]);
+  int expected = 0;
+  for (auto& item : a.queue) ASSERT_EQ(item.value, expected++);
+  a.queue.pop_front();
+  ASSERT_EQ(&a.queue.front(), &a.items[1]);
+  ASSERT_EQ(a.queue.size(), 3);
+}
+
+TEST(queue, hook_size) {
+  static_assert(sizeof(intrusive_list::forward_list_node) == sizeof(void*));
+  static_assert(sizeof(test_queue) == 2 * sizeof(void*));
+}
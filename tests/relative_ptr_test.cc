@@ -0,0 +1,238 @@
+#include "intrusive_list/relative_ptr.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "intrusive_list/forward_list.h"
+#include "intrusive_list/list.h"
+#include "test_helpers.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using test_helpers::values;
+
+struct relative_item {
+  int value;
+  intrusive_list::relative_list_node node;
+  intrusive_list::relative_forward_list_node forward_node;
+
+  bool operator<(const relative_item& rhs) const { return value < rhs.value; }
+  bool operator==(const relative_item& rhs) const {
+    return value == rhs.value;
+  }
+};
+
+using relative_list =
+    intrusive_list::list<relative_item, &relative_item::node, true>;
+using relative_forward_list =
+    intrusive_list::forward_list<relative_item, &relative_item::forward_node>;
+
+constexpr int kItems = 64;
+
+// Heads and items share one allocation so that all offsets stay small.
+struct relative_arena {
+  relative_list a;
+  relative_list b;
+  relative_forward_list fa;
+  relative_forward_list fb;
+  relative_item items[kItems];
+};
+
+}  // namespace
+
+TEST(relative_ptr, encoding) {
+  static_assert(sizeof(intrusive_list::relative_list_node) == 8);
+  static_assert(sizeof(intrusive_list::relative_forward_list_node) == 4);
+
+  struct pair {
+    intrusive_list::relative_forward_list_node first;
+    intrusive_list::relative_forward_list_node second;
+  } p;
+  ASSERT_EQ(p.first.next, nullptr);
+
+  p.first.next = &p.second;
+  p.second.next = &p.second;
+  ASSERT_EQ(p.first.next.get(), &p.second);
+  ASSERT_EQ(p.second.next.get(), &p.second);
+
+  // Copies keep pointing at the same target, not at the same distance.
+  p.second.next = p.first.next;
+  ASSERT_EQ(p.second.next.get(), &p.second);
+  p.first.next = nullptr;
+  ASSERT_FALSE(p.first.next);
+}
+
+TEST(relative_ptr, list) {
+  auto arena = std::make_unique<relative_arena>();
+  auto& list = arena->a;
+  for (int i = 0; i < kItems; ++i) {
+    arena->items[i].value = (i * 37) % kItems;
+    list.push_back(arena->items[i]);
+  }
+  ASSERT_EQ(list.size(), kItems);
+  ASSERT_EQ(list.front().value, 0);
+  ASSERT_EQ(list.back().value, (kItems - 1) * 37 % kItems);
+
+  list.sort();
+  std::vector<int> expected;
+  for (int i = 0; i < kItems; ++i) expected.push_back(i);
+  ASSERT_EQ(values(list), expected);
+
+  ASSERT_TRUE(list.remove_if_exists(arena->items[0]));
+  ASSERT_FALSE(list.remove_if_exists(arena->items[0]));
+  list.pop_front();
+  list.pop_back();
+  ASSERT_EQ(list.size(), kItems - 3);
+
+  // Split off the tail, then merge it back.
+  auto it = list.begin();
+  for (int i = 0; i < 10; ++i) ++it;
+  list.split_at(it, arena->b);
+  ASSERT_EQ(list.size() + arena->b.size(), kItems - 3);
+  list.merge(arena->b);
+  ASSERT_TRUE(arena->b.empty());
+  ASSERT_EQ(list.size(), kItems - 3);
+
+  arena->b.splice(arena->b.end(), list);
+  ASSERT_TRUE(list.empty());
+  list.swap(arena->b);
+  ASSERT_EQ(list.size(), kItems - 3);
+  ASSERT_TRUE(arena->b.empty());
+  ASSERT_EQ(values(list),
+            std::vector<int>(expected.begin() + 2, expected.end() - 1));
+
+  list.clear();
+  ASSERT_TRUE(list.empty());
+  ASSERT_FALSE(list.remove_if_exists(arena->items[5]));
+}
+
+TEST(relative_ptr, forward_list) {
+  auto arena = std::make_unique<relative_arena>();
+  auto& list = arena->fa;
+  for (int i = 0; i < kItems; ++i) {
+    arena->items[i].value = (i * 37) % kItems;
+    list.push_front(arena->items[i]);
+  }
+  ASSERT_EQ(list.size(), kItems);
+
+  list.sort();
+  ASSERT_EQ(list.front().value, 0);
+  ASSERT_EQ(list.remove_if([](const relative_item& i) { return i.value & 1; }),
+            kItems / 2);
+  ASSERT_EQ(list.size(), kItems / 2);
+
+  list.reverse();
+  ASSERT_EQ(list.front().value, kItems - 2);
+  list.reverse();
+
+  for (int i = 0; i < kItems; ++i) {
+    if (arena->items[i].value & 1) arena->fb.push_front(arena->items[i]);
+  }
+  arena->fb.sort();
+  list.merge(arena->fb);
+  ASSERT_TRUE(arena->fb.empty());
+
+  std::vector<int> expected;
+  for (int i = 0; i < kItems; ++i) expected.push_back(i);
+  ASSERT_EQ(values(list), expected);
+
+  ASSERT_EQ(list.unique([](const relative_item& a, const relative_item& b) {
+    return a.value / 2 == b.value / 2;
+  }),
+            kItems / 2);
+  ASSERT_EQ(list.size(), kItems / 2);
+}
+
+#ifdef __linux__
+
+namespace {
+
+struct shared_item {
+  int value;
+  intrusive_list::offset_list_node node;
+  intrusive_list::offset_forward_list_node free_node;
+};
+
+// Everything lives in the shared segment, including the list heads.
+struct shared_segment {
+  intrusive_list::list<shared_item, &shared_item::node, true> queue;
+  intrusive_list::forward_list<shared_item, &shared_item::free_node> free;
+  shared_item items[kItems];
+};
+
+bool consume_in_child(int fd, void* inherited) {
+  // Map the segment a second time, at another address, and drop the
+  // inherited mapping so that any absolute pointer into it would dangle.
+  void* memory = mmap(nullptr, sizeof(shared_segment), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED || memory == inherited) return false;
+  munmap(inherited, sizeof(shared_segment));
+  auto segment = static_cast<shared_segment*>(memory);
+
+  // Take the even items off the queue and hand them to the free list.
+  int expected = 0;
+  for (auto it = segment->queue.begin(); it != segment->queue.end();) {
+    if (it->value != expected++) return false;
+    if (it->value % 2 == 0) {
+      shared_item& item = *it;
+      it = segment->queue.erase(it);
+      segment->free.push_front(item);
+    } else {
+      ++it;
+    }
+  }
+  return expected == kItems && segment->queue.size() == kItems / 2;
+}
+
+}  // namespace
+
+TEST(relative_ptr, shared_memory_across_processes) {
+  int fd = memfd_create("relative_ptr_test", 0);
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(ftruncate(fd, sizeof(shared_segment)), 0);
+  void* memory = mmap(nullptr, sizeof(shared_segment), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  ASSERT_NE(memory, MAP_FAILED);
+
+  auto segment = new (memory) shared_segment{};
+  for (int i = 0; i < kItems; ++i) {
+    segment->items[i].value = i;
+    segment->queue.push_back(segment->items[i]);
+  }
+
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    _exit(consume_in_child(fd, memory) ? 0 : 1);
+  }
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
+  // The child's relinking is valid at our address as well.
+  ASSERT_EQ(segment->queue.size(), kItems / 2);
+  int expected = 1;
+  for (auto& item : segment->queue) {
+    ASSERT_EQ(item.value, expected);
+    expected += 2;
+  }
+  ASSERT_EQ(segment->free.size(), kItems / 2);
+  ASSERT_EQ(segment->free.front().value, kItems - 2);
+
+  segment->~shared_segment();
+  munmap(memory, sizeof(shared_segment));
+  close(fd);
+}
+
+#endif  // __linux__
@@ -0,0 +1,169 @@
+#include "intrusive_list/slab_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "intrusive_list/mpsc_queue.h"
+
+namespace {
+
+struct slab_test_object {
+  uint64_t payload[3];
+  intrusive_list::forward_list_node node;
+};
+
+using test_allocator = intrusive_list::slab_allocator<slab_test_object, 4096>;
+
+}  // namespace
+
+TEST(slab_allocator, local) {
+  test_allocator allocator;
+  test_allocator::thread_cache cache(allocator);
+
+  std::set<slab_test_object*> seen;
+  std::vector<slab_test_object*> objects;
+  for (int i = 0; i < 1000; ++i) {
+    auto p = cache.allocate();
+    ASSERT_TRUE(seen.insert(p).second);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(slab_test_object), 0);
+    objects.push_back(p);
+  }
+  size_t slabs = allocator.slab_count();
+  ASSERT_GT(slabs, 1);
+
+  for (auto p : objects) cache.deallocate(p);
+  for (int i = 0; i < 1000; ++i) ASSERT_EQ(seen.count(cache.allocate()), 1);
+  ASSERT_EQ(allocator.slab_count(), slabs);
+}
+
+TEST(slab_allocator, remote_free) {
+  test_allocator allocator;
+  test_allocator::thread_cache owner(allocator);
+
+  std::vector<slab_test_object*> objects;
+  for (int i = 0; i < 500; ++i) objects.push_back(owner.allocate());
+  size_t slabs = allocator.slab_count();
+
+  std::thread([&] {
+    test_allocator::thread_cache remote(allocator);
+    for (auto p : objects) remote.deallocate(p);
+  }).join();
+
+  // the owner gets the remote frees back instead of growing
+  std::set<slab_test_object*> expected(objects.begin(), objects.end());
+  size_t reused = 0;
+  for (int i = 0; i < 500; ++i) reused += expected.count(owner.allocate());
+  ASSERT_GT(reused, 0);
+  ASSERT_EQ(allocator.slab_count(), slabs);
+}
+
+TEST(slab_allocator, slab_handoff) {
+  test_allocator allocator;
+  std::set<slab_test_object*> freed;
+  {
+    test_allocator::thread_cache first(allocator);
+    std::vector<slab_test_object*> objects;
+    for (int i = 0; i < 300; ++i) objects.push_back(first.allocate());
+    for (int i = 0; i < 300; i += 2) {
+      first.deallocate(objects[i]);
+      freed.insert(objects[i]);
+    }
+  }
+  size_t slabs = allocator.slab_count();
+
+  // a new cache adopts the abandoned slabs, free slots included
+  test_allocator::thread_cache second(allocator);
+  size_t reused = 0;
+  for (size_t i = 0; i < freed.size(); ++i) {
+    reused += freed.count(second.allocate());
+  }
+  ASSERT_GT(reused, 0);
+  ASSERT_EQ(allocator.slab_count(), slabs);
+}
+
+TEST(slab_allocator, magazine_cap) {
+  test_allocator allocator;
+  test_allocator::thread_cache first(allocator);
+  test_allocator::thread_cache second(allocator);
+
+  std::vector<slab_test_object*> objects;
+  for (int i = 0; i < 2000; ++i) objects.push_back(first.allocate());
+  size_t slabs = allocator.slab_count();
+  for (auto p : objects) first.deallocate(p);
+
+  // first keeps at most 256 free slots, spread over at most 4 slabs, and
+  // gives its other slabs away
+  objects.clear();
+  for (int i = 0; i < 2000; ++i) objects.push_back(second.allocate());
+  ASSERT_LE(allocator.slab_count(), slabs + 4);
+  std::set<slab_test_object*> unique(objects.begin(), objects.end());
+  ASSERT_EQ(unique.size(), objects.size());
+  for (auto p : objects) second.deallocate(p);
+}
+
+TEST(slab_allocator, producer_consumer) {
+  constexpr int kProducers = 4;
+  constexpr int kItems = 50000;
+  constexpr int kMaxLive = 1024;
+  test_allocator allocator;
+  intrusive_list::mpsc_queue<slab_test_object, &slab_test_object::node> queue;
+  std::atomic<int> live{0};
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&, p] {
+      test_allocator::thread_cache cache(allocator);
+      for (int i = 0; i < kItems; ++i) {
+        while (live.fetch_add(1) >= kMaxLive) {
+          live.fetch_sub(1);
+          std::this_thread::yield();
+        }
+        auto object = new (cache.allocate()) slab_test_object{};
+        object->payload[0] = p;
+        object->payload[1] = i;
+        queue.push(*object);
+      }
+    });
+  }
+
+  // EXPECT while the producers are still joinable. An object whose slot
+  // was handed out again while live would show up with a wrong payload.
+  std::vector<std::vector<bool>> received(kProducers,
+                                          std::vector<bool>(kItems));
+  {
+    test_allocator::thread_cache cache(allocator);
+    int count = 0;
+    while (count < kProducers * kItems) {
+      auto object = queue.pop();
+      if (!object) {
+        std::this_thread::yield();
+        continue;
+      }
+      auto p = object->payload[0];
+      auto i = object->payload[1];
+      EXPECT_LT(p, kProducers);
+      EXPECT_LT(i, kItems);
+      if (p < kProducers && i < kItems) {
+        EXPECT_FALSE(received[p][i]);
+        received[p][i] = true;
+      }
+      cache.deallocate(object);
+      live.fetch_sub(1);
+      count++;
+    }
+  }
+  for (auto& t : producers) t.join();
+
+  for (auto& producer : received) {
+    for (bool r : producer) ASSERT_TRUE(r);
+  }
+  // A producer only gets a new slab once its own slabs hold nothing but
+  // live objects and one carve batch of at most 64 slots; a 4096 byte slab
+  // has over 100. With at most kMaxLive objects live that is below
+  // kMaxLive / 64 + 2 slabs per producer.
+  ASSERT_LE(allocator.slab_count(), kProducers * (kMaxLive / 64 + 2));
+}
@@ -0,0 +1,143 @@
+#include "intrusive_list/soa_list.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "test_helpers.h"
+
+namespace {
+
+using test_helpers::make_items;
+using test_helpers::values;
+
+struct soa_test_struct {
+  int value;
+};
+
+using test_soa_list = intrusive_list::soa_list<soa_test_struct>;
+using counted_soa_list =
+    intrusive_list::soa_list<soa_test_struct, uint16_t, true>;
+
+}  // namespace
+
+TEST(soa_list, no_hook_in_items) {
+  static_assert(sizeof(soa_test_struct) == sizeof(int));
+}
+
+TEST(soa_list, push_pop_rotate) {
+  auto items = make_items<soa_test_struct>(4);
+  intrusive_list::soa_links<> links(items.size());
+  test_soa_list list(items.data(), links);
+  ASSERT_TRUE(list.empty());
+
+  for (auto& i : items) list.push_back(i);
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 2, 3}));
+  ASSERT_EQ(list.size(), 4);
+  ASSERT_TRUE(links.is_linked(2));
+
+  list.rotate_left();
+  ASSERT_EQ(values(list), (std::vector<int>{1, 2, 3, 0}));
+  list.rotate_right();
+  list.rotate_right();
+  ASSERT_EQ(values(list), (std::vector<int>{3, 0, 1, 2}));
+
+  ASSERT_EQ(list.front().value, 3);
+  ASSERT_EQ(list.back().value, 2);
+  list.pop_front();
+  list.pop_back();
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1}));
+  ASSERT_FALSE(links.is_linked(3));
+
+  ASSERT_TRUE(list.remove_if_exists(items[0]));
+  ASSERT_FALSE(list.remove_if_exists(items[0]));
+  ASSERT_TRUE(list.is_singular());
+  list.rotate_left();
+  ASSERT_EQ(values(list), (std::vector<int>{1}));
+
+  list.clear();
+  ASSERT_TRUE(list.empty());
+  ASSERT_FALSE(links.is_linked(1));
+}
+
+TEST(soa_list, erase_insert) {
+  auto items = make_items<soa_test_struct>(6);
+  intrusive_list::soa_links<uint16_t> links(items.size());
+  counted_soa_list list(items.data(), links);
+  for (auto& i : items) list.push_front(i);
+
+  for (auto it = list.begin(); it != list.end();) {
+    if (it->value % 2) {
+      it = list.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(values(list), (std::vector<int>{4, 2, 0}));
+  ASSERT_EQ(list.size(), 3);
+
+  auto it = list.begin();
+  ++it;
+  ASSERT_EQ(list.insert(it, items[3])->value, 3);
+  list.insert(list.end(), items[5]);
+  ASSERT_EQ(values(list), (std::vector<int>{4, 3, 2, 0, 5}));
+  ASSERT_EQ(list.size(), 5);
+}
+
+TEST(soa_list, splice_between_lists) {
+  auto items = make_items<soa_test_struct>(10);
+  intrusive_list::soa_links<uint16_t> links(items.size());
+  counted_soa_list a(items.data(), links);
+  counted_soa_list b(items.data(), links);
+  for (int i = 0; i < 5; ++i) a.push_back(items[i]);
+  for (int i = 5; i < 10; ++i) b.push_back(items[i]);
+
+  // Move 6, 7 in front of 2.
+  auto pos = a.begin();
+  ++pos;
+  ++pos;
+  auto first = b.begin();
+  ++first;
+  auto last = first;
+  ++last;
+  ++last;
+  a.splice(pos, b, first, last);
+  ASSERT_EQ(values(a), (std::vector<int>{0, 1, 6, 7, 2, 3, 4}));
+  ASSERT_EQ(values(b), (std::vector<int>{5, 8, 9}));
+  ASSERT_EQ(a.size(), 7);
+  ASSERT_EQ(b.size(), 3);
+
+  // Move the tail of a to the front of a.
+  first = a.begin();
+  for (int i = 0; i < 5; ++i) ++first;
+  a.splice(a.begin(), a, first, a.end());
+  ASSERT_EQ(values(a), (std::vector<int>{3, 4, 0, 1, 6, 7, 2}));
+  ASSERT_EQ(a.back().value, 2);
+
+  a.splice(a.end(), b);
+  ASSERT_TRUE(b.empty());
+  ASSERT_EQ(values(a), (std::vector<int>{3, 4, 0, 1, 6, 7, 2, 5, 8, 9}));
+  ASSERT_EQ(a.size(), 10);
+
+  a.swap(b);
+  ASSERT_TRUE(a.empty());
+  ASSERT_EQ(b.size(), 10);
+  ASSERT_EQ(b.front().value, 3);
+}
+
+TEST(soa_list, grow_and_rebase) {
+  auto items = make_items<soa_test_struct>(3);
+  intrusive_list::soa_links<> links(items.size());
+  test_soa_list list(items.data(), links);
+  for (auto& i : items) list.push_back(i);
+
+  items.push_back({3});
+  items.push_back({4});
+  links.grow(items.size());
+  list.rebase(items.data());
+  list.push_front(items[4]);
+  list.push_back(items[3]);
+  ASSERT_EQ(values(list), (std::vector<int>{4, 0, 1, 2, 3}));
+  ASSERT_EQ(links.capacity(), 5);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+/*
+ * Helpers shared by the tests of containers whose items carry an int
+ * value field.
+ */
+namespace test_helpers {
+
+/**
+ * the value fields of range in iteration order.
+ */
+template <typename Range>
+std::vector<int> values(const Range& range) {
+  std::vector<int> ret;
+  for (auto& i : range) ret.push_back(i.value);
+  return ret;
+}
+
+/**
+ * the value fields of list from back to front.
+ */
+template <typename List>
+std::vector<int> reverse_values(const List& list) {
+  std::vector<int> ret;
+  for (auto i = list.rbegin(); i != list.rend(); ++i) ret.push_back(i->value);
+  return ret;
+}
+
+/**
+ * n value-initialized items with value fields 0 to n - 1.
+ */
+template <typename T>
+std::vector<T> make_items(int n) {
+  std::vector<T> items(n);
+  for (int i = 0; i < n; ++i) items[i].value = i;
+  return items;
+}
+
+}  // namespace test_helpers
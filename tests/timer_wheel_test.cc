@@ -0,0 +1,142 @@
+#include "intrusive_list/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+struct timer_node {
+  timer_node* next;
+  timer_node* prev;
+};
+
+struct test_timer {
+  int id;
+  uint64_t expires;
+  uint64_t fired_at;
+  timer_node node;
+};
+
+using test_wheel = intrusive_list::timer_wheel<test_timer, &test_timer::node,
+                                               &test_timer::expires>;
+
+}  // namespace
+
+TEST(timer_wheel, schedule_expire) {
+  std::vector<test_timer> t(4);
+  test_wheel wheel;
+  wheel.schedule(t[0], 0);
+  wheel.schedule(t[1], 5);
+  wheel.schedule(t[2], 300);
+  wheel.schedule(t[3], 70000);
+  ASSERT_EQ(wheel.size(), 4);
+
+  std::vector<test_timer*> fired;
+  auto record = [&](test_timer& timer) { fired.push_back(&timer); };
+
+  ASSERT_EQ(wheel.advance(4, record), 1);
+  ASSERT_EQ(fired, std::vector<test_timer*>({&t[0]}));
+  ASSERT_EQ(wheel.advance(5, record), 1);
+  ASSERT_EQ(fired.back(), &t[1]);
+  ASSERT_EQ(wheel.advance(299, record), 0);
+  ASSERT_EQ(wheel.advance(300, record), 1);
+  ASSERT_EQ(fired.back(), &t[2]);
+  ASSERT_EQ(wheel.advance(69999, record), 0);
+  ASSERT_EQ(wheel.advance(70000, record), 1);
+  ASSERT_EQ(fired.back(), &t[3]);
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, cancel_reschedule) {
+  std::vector<test_timer> t(3);
+  test_wheel wheel(1000);
+  wheel.schedule(t[0], 1010);
+  wheel.schedule(t[1], 1020);
+  wheel.schedule(t[2], 5000);
+
+  ASSERT_TRUE(wheel.cancel(t[1]));
+  ASSERT_FALSE(wheel.cancel(t[1]));
+  wheel.schedule(t[2], 1005);  // re-arm earlier
+  ASSERT_EQ(wheel.size(), 2);
+
+  std::vector<test_timer*> fired;
+  wheel.advance(2000, [&](test_timer& timer) { fired.push_back(&timer); });
+  ASSERT_EQ(fired, std::vector<test_timer*>({&t[2], &t[0]}));
+
+  // timers in the past expire on the next tick
+  wheel.schedule(t[1], 10);
+  ASSERT_EQ(wheel.advance(2001, [](test_timer&) {}), 1);
+}
+
+TEST(timer_wheel, callback_reschedules) {
+  std::vector<test_timer> t(2);
+  test_wheel wheel;
+  wheel.schedule(t[0], 10);
+  wheel.schedule(t[1], 10);
+
+  int fires = 0;
+  auto on_expire = [&](test_timer& timer) {
+    fires++;
+    if (&timer == &t[0] && fires == 1) {
+      ASSERT_TRUE(wheel.cancel(t[1]));  // still in the batch being expired
+      wheel.schedule(t[0], 500);
+    }
+  };
+  ASSERT_EQ(wheel.advance(100, on_expire), 1);
+  ASSERT_EQ(wheel.size(), 1);
+  ASSERT_EQ(wheel.advance(500, on_expire), 1);
+  ASSERT_EQ(fires, 2);
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(timer_wheel, matches_reference) {
+  constexpr int kTimers = 5000;
+  std::vector<test_timer> t(kTimers);
+  test_wheel wheel;
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<uint64_t> short_range(0, 1000);
+  std::uniform_int_distribution<uint64_t> long_range(0, uint64_t(1) << 22);
+
+  for (int i = 0; i < kTimers; ++i) {
+    t[i].id = i;
+    wheel.schedule(t[i], i % 4 ? short_range(rng) : long_range(rng));
+  }
+  for (int i = 0; i < kTimers; i += 7) wheel.cancel(t[i]);
+
+  size_t fired = 0;
+  uint64_t now = 0;
+  while (!wheel.empty()) {
+    now += 997;
+    fired += wheel.advance(now, [&](test_timer& timer) {
+      // never early, and late by at most one advance() step
+      ASSERT_LE(timer.expires, now);
+      ASSERT_GE(timer.expires + 997, now);
+      timer.fired_at = now;
+    });
+  }
+  ASSERT_EQ(fired, kTimers - (kTimers + 6) / 7);
+  for (int i = 0; i < kTimers; ++i) {
+    if (i % 7) {
+      ASSERT_NE(t[i].fired_at, 0);
+    }
+  }
+}
+
+TEST(timer_wheel, far_future) {
+  std::vector<test_timer> t(1);
+  test_wheel wheel;
+  uint64_t expires = (uint64_t(1) << 32) + 12345;
+  wheel.schedule(t[0], expires);
+
+  // beyond the range of the wheel, the timer is re-placed until it fits
+  size_t fired = 0;
+  uint64_t now = 0;
+  while (fired == 0) {
+    now += uint64_t(1) << 20;
+    fired = wheel.advance(
+        now, [&](test_timer& timer) { timer.fired_at = wheel.now() - 1; });
+  }
+  ASSERT_EQ(t[0].fired_at, expires);
+}
@@ -0,0 +1,160 @@
+#include "intrusive_list/tlsf.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+constexpr size_t kArenaSize = 1 << 20;
+
+struct tlsf_arena {
+  alignas(std::max_align_t) unsigned char bytes[kArenaSize];
+};
+
+}  // namespace
+
+TEST(tlsf, allocate_deallocate) {
+  auto arena = std::make_unique<tlsf_arena>();
+  intrusive_list::tlsf_allocator tlsf(arena->bytes, kArenaSize);
+  size_t initial = tlsf.free_bytes();
+  ASSERT_GT(initial, kArenaSize - 64);
+  ASSERT_EQ(tlsf.largest_free_block(), initial);
+
+  void *a = tlsf.allocate(100);
+  void *b = tlsf.allocate(1);
+  void *c = tlsf.allocate(5000);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  ASSERT_NE(c, nullptr);
+  for (auto p : {a, b, c}) {
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % (2 * sizeof(void *)), 0);
+    ASSERT_GE(static_cast<unsigned char *>(p), arena->bytes);
+    ASSERT_LT(static_cast<unsigned char *>(p), arena->bytes + kArenaSize);
+  }
+  ASSERT_GE(intrusive_list::tlsf_allocator::usable_size(a), 100);
+  ASSERT_GE(intrusive_list::tlsf_allocator::usable_size(c), 5000);
+  ASSERT_LT(tlsf.free_bytes(), initial - 5100);
+
+  memset(a, 0xaa, 100);
+  memset(b, 0xbb, 1);
+  memset(c, 0xcc, 5000);
+
+  // Free in an order that exercises merging with both neighbours.
+  tlsf.deallocate(a);
+  tlsf.deallocate(c);
+  tlsf.deallocate(b);
+  ASSERT_EQ(tlsf.free_bytes(), initial);
+  ASSERT_EQ(tlsf.largest_free_block(), initial);
+
+  tlsf.deallocate(nullptr);
+}
+
+TEST(tlsf, exhaustion) {
+  auto arena = std::make_unique<tlsf_arena>();
+  intrusive_list::tlsf_allocator tlsf(arena->bytes, kArenaSize);
+
+  ASSERT_EQ(tlsf.allocate(kArenaSize), nullptr);
+  ASSERT_EQ(tlsf.allocate(intrusive_list::tlsf_allocator::kMaxAllocation + 1),
+            nullptr);
+
+  std::vector<void *> blocks;
+  while (void *p = tlsf.allocate(4096)) blocks.push_back(p);
+  ASSERT_GT(blocks.size(), kArenaSize / 4096 - 8);
+  ASSERT_LT(tlsf.free_bytes(), 8192);
+
+  // Every other block free: plenty of memory, no room for 8192.
+  for (size_t i = 0; i < blocks.size(); i += 2) tlsf.deallocate(blocks[i]);
+  ASSERT_EQ(tlsf.allocate(8192), nullptr);
+  ASSERT_NE(tlsf.allocate(4096), nullptr);
+}
+
+TEST(tlsf, largest_block) {
+  auto arena = std::make_unique<tlsf_arena>();
+  intrusive_list::tlsf_allocator tlsf(arena->bytes, kArenaSize);
+
+  // Not on a class boundary, so rounding up leaves no class that fits.
+  size_t largest = tlsf.largest_free_block();
+  void *p = tlsf.allocate(largest);
+  ASSERT_NE(p, nullptr);
+  ASSERT_EQ(tlsf.free_bytes(), 0);
+  ASSERT_EQ(tlsf.allocate(16), nullptr);
+  tlsf.deallocate(p);
+  ASSERT_EQ(tlsf.largest_free_block(), largest);
+
+  // The same for the tail left over by a split.
+  void *small = tlsf.allocate(largest / 2);
+  ASSERT_NE(small, nullptr);
+  size_t rest = tlsf.largest_free_block();
+  ASSERT_NE(tlsf.allocate(rest), nullptr);
+  ASSERT_EQ(tlsf.allocate(16), nullptr);
+}
+
+#ifdef __linux__
+TEST(tlsf, max_allocation) {
+  constexpr size_t kMax = intrusive_list::tlsf_allocator::kMaxAllocation;
+  // Only the block headers are touched, reserve address space only.
+  size_t bytes = kMax + 4096;
+  void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (memory == MAP_FAILED) GTEST_SKIP() << "cannot reserve the arena";
+
+  {
+    intrusive_list::tlsf_allocator tlsf(memory, bytes);
+    ASSERT_EQ(tlsf.largest_free_block(), kMax);
+    void *p = tlsf.allocate(kMax);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(intrusive_list::tlsf_allocator::usable_size(p), kMax);
+    tlsf.deallocate(p);
+    ASSERT_NE(tlsf.allocate(kMax - 4096), nullptr);
+  }
+  munmap(memory, bytes);
+}
+#endif
+
+TEST(tlsf, tiny_arena) {
+  unsigned char bytes[16];
+  intrusive_list::tlsf_allocator tlsf(bytes, sizeof(bytes));
+  ASSERT_EQ(tlsf.free_bytes(), 0);
+  ASSERT_EQ(tlsf.allocate(1), nullptr);
+}
+
+TEST(tlsf, random_stress) {
+  auto arena = std::make_unique<tlsf_arena>();
+  intrusive_list::tlsf_allocator tlsf(arena->bytes, kArenaSize);
+  size_t initial = tlsf.free_bytes();
+
+  std::mt19937 rng(7);
+  std::vector<std::pair<unsigned char *, size_t>> live;
+  for (int round = 0; round < 20000; ++round) {
+    if (live.empty() || rng() % 3 != 0) {
+      size_t size = rng() % 4 == 0 ? rng() % 20000 : rng() % 256;
+      auto p = static_cast<unsigned char *>(tlsf.allocate(size));
+      if (!p) continue;
+      memset(p, static_cast<int>(size & 0xff), size);
+      live.emplace_back(p, size);
+    } else {
+      size_t index = rng() % live.size();
+      auto [p, size] = live[index];
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(p[i], static_cast<unsigned char>(size & 0xff));
+      }
+      tlsf.deallocate(p);
+      live[index] = live.back();
+      live.pop_back();
+    }
+  }
+
+  for (auto [p, size] : live) tlsf.deallocate(p);
+  ASSERT_EQ(tlsf.free_bytes(), initial);
+  ASSERT_EQ(tlsf.largest_free_block(), initial);
+}
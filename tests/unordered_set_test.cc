@@ -0,0 +1,113 @@
+#include "intrusive_list/unordered_set.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct set_test_struct {
+  int key;
+  intrusive_list::forward_list_node node;
+};
+
+struct key_of {
+  int operator()(const set_test_struct& item) const { return item.key; }
+};
+
+using test_set =
+    intrusive_list::unordered_set<set_test_struct, &set_test_struct::node,
+                                  key_of>;
+
+}  // namespace
+
+TEST(unordered_set, insert_find_erase) {
+  std::array<set_test_struct, 3> s{{{1, {}}, {2, {}}, {3, {}}}};
+  test_set set;
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(set.find(1), nullptr);
+
+  for (auto& i : s) ASSERT_TRUE(set.insert(i));
+  ASSERT_EQ(set.size(), 3);
+  for (auto& i : s) ASSERT_EQ(set.find(i.key), &i);
+  ASSERT_FALSE(set.contains(4));
+
+  set_test_struct duplicate{2, {}};
+  ASSERT_FALSE(set.insert(duplicate));
+  ASSERT_EQ(set.find(2), &s[1]);
+
+  ASSERT_FALSE(set.erase(duplicate));
+  ASSERT_TRUE(set.erase(s[1]));
+  ASSERT_EQ(set.find(2), nullptr);
+  ASSERT_EQ(set.erase(3), &s[2]);
+  ASSERT_EQ(set.erase(3), nullptr);
+  ASSERT_EQ(set.size(), 1);
+
+  set.clear();
+  ASSERT_TRUE(set.empty());
+  ASSERT_EQ(set.find(1), nullptr);
+}
+
+TEST(unordered_set, grow) {
+  std::vector<set_test_struct> s(10000);
+  test_set set(1);
+  ASSERT_EQ(set.bucket_count(), 1);
+
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].key = static_cast<int>(i * 7);
+    ASSERT_TRUE(set.insert(s[i]));
+  }
+  ASSERT_EQ(set.size(), s.size());
+  ASSERT_GE(set.bucket_count(), s.size());
+  ASSERT_EQ(set.bucket_count() & (set.bucket_count() - 1), 0);
+  ASSERT_LE(set.load_factor(), 1.0f);
+
+  for (auto& i : s) ASSERT_EQ(set.find(i.key), &i);
+  ASSERT_EQ(set.find(1), nullptr);
+
+  // shrinking never goes below size()
+  set.rehash(1);
+  ASSERT_GE(set.bucket_count(), s.size());
+  for (auto& i : s) ASSERT_EQ(set.find(i.key), &i);
+}
+
+TEST(unordered_set, iterator) {
+  std::vector<set_test_struct> s(100);
+  test_set set;
+  std::set<int> expected;
+  for (size_t i = 0; i < s.size(); ++i) {
+    s[i].key = static_cast<int>(i);
+    set.insert(s[i]);
+    expected.insert(s[i].key);
+  }
+
+  std::set<int> seen;
+  for (auto& i : set) ASSERT_TRUE(seen.insert(i.key).second);
+  ASSERT_EQ(seen, expected);
+
+  test_set empty;
+  ASSERT_EQ(empty.begin(), empty.end());
+}
+
+TEST(unordered_set, string_key) {
+  struct named {
+    std::string name;
+    intrusive_list::forward_list_node node;
+  };
+  struct name_of {
+    const std::string& operator()(const named& item) const {
+      return item.name;
+    }
+  };
+  intrusive_list::unordered_set<named, &named::node, name_of> set;
+  named a{"alpha", {}};
+  named b{"beta", {}};
+  set.insert(a);
+  set.insert(b);
+  ASSERT_EQ(set.find("alpha"), &a);
+  ASSERT_EQ(set.find("beta"), &b);
+  ASSERT_EQ(set.find("gamma"), nullptr);
+}
@@ -0,0 +1,129 @@
+#include "intrusive_list/xor_list.h"
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "test_helpers.h"
+
+namespace {
+
+using test_helpers::make_items;
+using test_helpers::reverse_values;
+using test_helpers::values;
+
+struct xor_test_struct {
+  int value;
+  intrusive_list::xor_list_node node;
+};
+
+using test_xor_list =
+    intrusive_list::xor_list<xor_test_struct, &xor_test_struct::node>;
+using counted_xor_list =
+    intrusive_list::xor_list<xor_test_struct, &xor_test_struct::node, true>;
+
+}  // namespace
+
+TEST(xor_list, hook_size) {
+  static_assert(sizeof(intrusive_list::xor_list_node) == sizeof(void*));
+}
+
+TEST(xor_list, push_pop) {
+  auto items = make_items<xor_test_struct>(4);
+  test_xor_list list;
+  ASSERT_TRUE(list.empty());
+
+  list.push_back(items[1]);
+  ASSERT_TRUE(list.is_singular());
+  list.push_back(items[2]);
+  list.push_front(items[0]);
+  list.push_back(items[3]);
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 2, 3}));
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{3, 2, 1, 0}));
+  ASSERT_EQ(list.size(), 4);
+  ASSERT_EQ(list.front().value, 0);
+  ASSERT_EQ(list.back().value, 3);
+
+  list.pop_front();
+  list.pop_back();
+  ASSERT_EQ(values(list), (std::vector<int>{1, 2}));
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{2, 1}));
+
+  list.pop_back();
+  ASSERT_TRUE(list.is_singular());
+  ASSERT_EQ(list.back().value, 1);
+  list.pop_front();
+  ASSERT_TRUE(list.empty());
+}
+
+TEST(xor_list, reverse_and_move) {
+  auto items = make_items<xor_test_struct>(5);
+  test_xor_list list;
+  for (auto& i : items) list.push_back(i);
+
+  list.reverse();
+  ASSERT_EQ(values(list), (std::vector<int>{4, 3, 2, 1, 0}));
+  list.pop_front();
+  ASSERT_EQ(values(list), (std::vector<int>{3, 2, 1, 0}));
+  list.push_front(items[4]);
+  list.reverse();
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 2, 3, 4}));
+
+  test_xor_list moved(std::move(list));
+  ASSERT_TRUE(list.empty());
+  ASSERT_EQ(values(moved), (std::vector<int>{0, 1, 2, 3, 4}));
+  list = std::move(moved);
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{4, 3, 2, 1, 0}));
+}
+
+TEST(xor_list, erase_insert) {
+  auto items = make_items<xor_test_struct>(6);
+  counted_xor_list list;
+  for (auto& i : items) list.push_back(i);
+
+  ASSERT_EQ(list.remove_if([](const xor_test_struct& i) {
+    return i.value % 2 == 0;
+  }),
+            3);
+  ASSERT_EQ(values(list), (std::vector<int>{1, 3, 5}));
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{5, 3, 1}));
+  ASSERT_EQ(list.size(), 3);
+
+  list.insert(list.begin(), items[0]);
+  list.insert(list.end(), items[4]);
+  auto it = list.begin();
+  ++it;
+  ++it;
+  ASSERT_EQ(list.insert(it, items[2])->value, 2);
+  ASSERT_EQ(values(list), (std::vector<int>{0, 1, 2, 3, 5, 4}));
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{4, 5, 3, 2, 1, 0}));
+  ASSERT_EQ(list.size(), 6);
+
+  // Erasing while walking backwards.
+  for (auto i = list.rbegin(); i != list.rend();) {
+    if (i->value == 4 || i->value == 1) {
+      i = list.erase(i);
+    } else {
+      ++i;
+    }
+  }
+  ASSERT_EQ(values(list), (std::vector<int>{0, 2, 3, 5}));
+  ASSERT_EQ(reverse_values(list), (std::vector<int>{5, 3, 2, 0}));
+  ASSERT_EQ(list.size(), 4);
+
+  list.clear();
+  ASSERT_TRUE(list.empty());
+  list.insert(list.end(), items[1]);
+  ASSERT_TRUE(list.is_singular());
+  ASSERT_EQ(list.front().value, 1);
+}
+
+TEST(xor_list, erase_singular_backwards) {
+  auto items = make_items<xor_test_struct>(1);
+  test_xor_list list;
+  list.push_back(items[0]);
+  auto it = list.erase(list.rbegin());
+  ASSERT_TRUE(it == list.rend());
+  ASSERT_TRUE(list.empty());
+}